@@ -15,6 +15,7 @@ if (typeof MockMusicEngine === 'undefined') {
     ];
     this.training_step = 0;
     this.epsilon = 0.1;
+    this.activationSampling = 0;
   }
 
   initialize() {
@@ -226,6 +227,12 @@ if (typeof MockMusicEngine === 'undefined') {
     console.log(`🎯 Training step ${this.training_step}: action=${action}, reward=${reward.toFixed(2)}, ε=${this.epsilon.toFixed(3)}, acc=${(this.accuracy * 100).toFixed(1)}%`);
   }
 
+  // The native engine only records activations for every n-th prediction
+  // (0 = never); the mock always has them, so it just remembers the rate.
+  setActivationSampling(everyN) {
+    this.activationSampling = Math.max(0, Math.floor(everyN));
+  }
+
   getActivations(layer) {
     if (layer < 0 || layer >= this.layers.length) {
       return [];
@@ -233,6 +240,33 @@ if (typeof MockMusicEngine === 'undefined') {
     return [...this.layers[layer].neurons];
   }
 
+  // Mirrors the native getLayerSummaries: one pass per layer computing the
+  // active count (> 0.1), max, mean and low/medium/high buckets (0.3 / 0.7)
+  getLayerSummaries() {
+    return this.layers.map((layer, index) => {
+      let active = 0, low = 0, medium = 0, sum = 0;
+      let max = layer.neurons.length > 0 ? -Infinity : 0;
+      for (const a of layer.neurons) {
+        if (a > 0.1) active++;
+        if (a < 0.3) low++;
+        else if (a < 0.7) medium++;
+        if (a > max) max = a;
+        sum += a;
+      }
+      const count = layer.neurons.length;
+      return {
+        layer: index,
+        neuronCount: count,
+        activeCount: active,
+        lowCount: low,
+        mediumCount: medium,
+        highCount: count - low - medium,
+        maxActivation: max,
+        meanActivation: count > 0 ? sum / count : 0
+      };
+    });
+  }
+
   getLayerInfo() {
     return this.layers.map(layer => ({
       name: layer.name,
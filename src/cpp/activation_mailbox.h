@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+// One captured forward pass: input, each hidden layer, Q-values
+struct ActivationSnapshot {
+    uint64_t sequence = 0;  // Increases with every capture
+    std::vector<Eigen::VectorXd> layers;
+};
+
+// Single-slot, lock-free hand-off from the serving path to the visualizer.
+// publish() replaces whatever is still waiting (the UI only wants the latest
+// capture) and take() empties the slot; both are one atomic exchange, so
+// neither side ever blocks the other.
+class ActivationMailbox {
+private:
+    std::atomic<ActivationSnapshot*> slot_;
+    
+public:
+    ActivationMailbox() : slot_(nullptr) {}
+    ~ActivationMailbox() { delete slot_.exchange(nullptr); }
+    
+    ActivationMailbox(const ActivationMailbox&) = delete;
+    ActivationMailbox& operator=(const ActivationMailbox&) = delete;
+    
+    void publish(std::unique_ptr<ActivationSnapshot> snapshot) {
+        delete slot_.exchange(snapshot.release(), std::memory_order_acq_rel);
+    }
+    
+    // Returns nullptr when nothing new has been published since the last take
+    std::unique_ptr<ActivationSnapshot> take() {
+        return std::unique_ptr<ActivationSnapshot>(slot_.exchange(nullptr, std::memory_order_acq_rel));
+    }
+    
+    bool empty() const { return slot_.load(std::memory_order_acquire) == nullptr; }
+};
+
+} // namespace MusicAI
@@ -0,0 +1,153 @@
+#include "async_trainer.h"
+#include "dqn_update.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+AsyncTrainer::AsyncTrainer(const NeuralNetwork& initial, const Config& config)
+    : config_(config), online_(initial), target_(initial), buffer_(config.buffer_capacity, config.seed),
+      published_(std::make_shared<const NeuralNetwork>(initial)),
+      stopping_(false), busy_(false), update_credit_(0.0), updates_since_publish_(0),
+      events_ingested_(0), events_dropped_(0), updates_(0), publishes_(0) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    throw std::runtime_error("Background training requires a build with thread support");
+#endif
+    if (config_.queue_capacity == 0 || config_.publish_interval <= 0 ||
+        config_.target_update_freq <= 0 || config_.batch_size == 0) {
+        throw std::invalid_argument("Invalid background training configuration");
+    }
+    thread_ = std::thread(&AsyncTrainer::run, this);
+}
+
+AsyncTrainer::~AsyncTrainer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    space_available_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool AsyncTrainer::enqueue(const Experience& experience) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (queue_.size() >= config_.queue_capacity) {
+            if (config_.backpressure == Backpressure::DROP) {
+                ++events_dropped_;
+                return false;
+            }
+            space_available_.wait(lock, [this]() {
+                return stopping_ || queue_.size() < config_.queue_capacity;
+            });
+        }
+        queue_.push_back(experience);
+    }
+    work_available_.notify_one();
+    return true;
+}
+
+std::shared_ptr<const NeuralNetwork> AsyncTrainer::snapshot() const {
+    return std::atomic_load(&published_);
+}
+
+void AsyncTrainer::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+}
+
+AsyncTrainer::Stats AsyncTrainer::getStats() const {
+    Stats stats;
+    stats.events_ingested = events_ingested_.load();
+    stats.events_dropped = events_dropped_.load();
+    stats.updates = updates_.load();
+    stats.publishes = publishes_.load();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.queue_depth = queue_.size();
+    }
+    return stats;
+}
+
+void AsyncTrainer::publish() {
+    std::atomic_store(&published_, std::shared_ptr<const NeuralNetwork>(
+        std::make_shared<const NeuralNetwork>(online_)));
+    updates_since_publish_ = 0;
+    ++publishes_;
+}
+
+void AsyncTrainer::run() {
+    // Events are drained only as fast as the update ratio allows, so a
+    // trainer that falls behind shows up as queue depth (and backpressure)
+    // rather than as an ever-growing update debt
+    double ratio = std::max(0.0, config_.updates_per_event);
+    size_t events_per_round = ratio > 0.0
+        ? std::max<size_t>(1, static_cast<size_t>(std::ceil(1.0 / ratio)))
+        : config_.queue_capacity;
+    std::vector<Experience> drained;
+    drained.reserve(events_per_round);
+    uint64_t events_seen = 0;
+    
+    while (true) {
+        bool publish_now = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (queue_.empty()) {
+                if (updates_since_publish_ > 0) {
+                    // Caught up: make the latest parameters visible to serving
+                    publish_now = true;
+                } else {
+                    busy_ = false;
+                    idle_.notify_all();
+                    work_available_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                    if (queue_.empty()) {
+                        break;
+                    }
+                }
+            }
+            if (!publish_now) {
+                busy_ = true;
+                size_t take = std::min(queue_.size(), events_per_round);
+                for (size_t i = 0; i < take; ++i) {
+                    drained.push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+            }
+        }
+        if (publish_now) {
+            publish();
+            continue;
+        }
+        space_available_.notify_all();
+        
+        for (const auto& experience : drained) {
+            buffer_.add(experience);
+            if (++events_seen % config_.target_update_freq == 0) {
+                target_ = online_;
+            }
+        }
+        events_ingested_ += drained.size();
+        update_credit_ += ratio * drained.size();
+        drained.clear();
+        
+        while (update_credit_ >= 1.0) {
+            update_credit_ -= 1.0;
+            // Like the inline path, no updates are owed before the buffer can
+            // fill a minibatch
+            if (!buffer_.canSample(config_.batch_size)) {
+                continue;
+            }
+            doubleDQNUpdate(online_, target_, buffer_.sample(config_.batch_size), config_.gamma);
+            ++updates_;
+            if (++updates_since_publish_ >= static_cast<uint64_t>(config_.publish_interval)) {
+                publish();
+            }
+        }
+    }
+}
+
+} // namespace MusicAI
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "neural_network.h"
+#include "experience_buffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace MusicAI {
+
+// Runs DQN replay on a dedicated thread so that ingesting feedback is only
+// an enqueue. The trainer owns its own online/target networks and replay
+// buffer and periodically publishes an immutable snapshot of the online
+// network, which the serving side reads without taking a lock.
+class AsyncTrainer {
+public:
+    enum class Backpressure {
+        BLOCK,  // enqueue waits for the trainer to catch up
+        DROP    // enqueue discards the event and reports it
+    };
+    
+    struct Config {
+        double updates_per_event = 1.0;   // Replay minibatches per ingested transition
+        size_t queue_capacity = 4096;     // Pending events before backpressure applies
+        Backpressure backpressure = Backpressure::BLOCK;
+        int publish_interval = 8;         // Updates between published snapshots
+        int target_update_freq = 100;     // Events between target network syncs
+        size_t batch_size = 32;
+        size_t buffer_capacity = 10000;
+        double gamma = 0.95;
+        uint64_t seed = 42;               // Replay sampling
+    };
+    
+    struct Stats {
+        uint64_t events_ingested;
+        uint64_t events_dropped;
+        uint64_t updates;
+        uint64_t publishes;
+        size_t queue_depth;
+    };
+    
+private:
+    Config config_;
+    NeuralNetwork online_;
+    NeuralNetwork target_;
+    ExperienceBuffer buffer_;
+    std::shared_ptr<const NeuralNetwork> published_;  // Accessed via std::atomic_load/store
+    
+    mutable std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable space_available_;
+    std::condition_variable idle_;
+    std::deque<Experience> queue_;
+    bool stopping_;
+    bool busy_;
+    
+    double update_credit_;
+    uint64_t updates_since_publish_;
+    std::atomic<uint64_t> events_ingested_;
+    std::atomic<uint64_t> events_dropped_;
+    std::atomic<uint64_t> updates_;
+    std::atomic<uint64_t> publishes_;
+    
+    std::thread thread_;
+    
+public:
+    AsyncTrainer(const NeuralNetwork& initial, const Config& config);
+    ~AsyncTrainer();
+    
+    AsyncTrainer(const AsyncTrainer&) = delete;
+    AsyncTrainer& operator=(const AsyncTrainer&) = delete;
+    
+    // Hands a transition to the trainer; false if it was dropped
+    bool enqueue(const Experience& experience);
+    
+    // Latest published parameters; never blocks on training
+    std::shared_ptr<const NeuralNetwork> snapshot() const;
+    
+    // Number of snapshots published so far; incremented after the snapshot
+    // is visible, so a count read before snapshot() never outruns it
+    uint64_t publishCount() const { return publishes_.load(std::memory_order_acquire); }
+    
+    // Waits until every queued event has been trained on, then publishes
+    void flush();
+    
+    Stats getStats() const;
+    const Config& getConfig() const { return config_; }
+    
+private:
+    void run();
+    void publish();
+};
+
+} // namespace MusicAI
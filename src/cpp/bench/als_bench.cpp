@@ -0,0 +1,97 @@
+#include "implicit_als.h"
+#include "fast_rng.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+using namespace MusicAI;
+
+namespace {
+
+constexpr int TASTE_GROUPS = 64;
+
+// Synthetic play counts: each user belongs to a taste group, and 80% of
+// their tracks come from that group's slice of the catalog. Row u also
+// returns one held-out in-group track for the hit-rate check.
+ImplicitALS::PlayMatrix makePlays(size_t users, size_t tracks, int plays_per_user, std::vector<uint32_t>& held_out) {
+    FastRng rng(13);
+    const size_t group_size = tracks / TASTE_GROUPS;
+    auto groupTrack = [&](size_t user) {
+        return static_cast<uint32_t>((user % TASTE_GROUPS) * group_size + rng() % group_size);
+    };
+    
+    ImplicitALS::PlayMatrix plays(users, tracks);
+    plays.reserve(Eigen::VectorXi::Constant(users, plays_per_user));
+    held_out.resize(users);
+    std::vector<uint32_t> row;
+    for (size_t u = 0; u < users; ++u) {
+        row.clear();
+        for (int p = 0; p < plays_per_user; ++p) {
+            row.push_back(rng.uniform() < 0.8 ? groupTrack(u) : static_cast<uint32_t>(rng() % tracks));
+        }
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        do {
+            held_out[u] = groupTrack(u);
+        } while (std::binary_search(row.begin(), row.end(), held_out[u]));
+        for (uint32_t track : row) {
+            plays.insert(u, track) = static_cast<float>(1 + rng() % 8);
+        }
+    }
+    plays.makeCompressed();
+    return plays;
+}
+
+} // namespace
+
+// Fits implicit ALS on a synthetic play matrix and reports time per sweep,
+// the loss after each sweep, and hit rate@50 of a held-out in-taste track
+// for a sample of users (a random ranking scores about 50 / tracks).
+// Usage: als_bench [users] [tracks] [plays_per_user] [factors] [iterations] [threads]
+int main(int argc, char** argv) {
+    size_t users = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t tracks = argc > 2 ? std::stoul(argv[2]) : 100000;
+    int plays_per_user = argc > 3 ? std::stoi(argv[3]) : 20;
+    ImplicitALS::Config config;
+    config.factors = argc > 4 ? std::stoi(argv[4]) : 16;
+    config.iterations = argc > 5 ? std::stoi(argv[5]) : 5;
+    config.num_threads = argc > 6 ? static_cast<unsigned>(std::stoul(argv[6])) : 0;
+    
+    std::vector<uint32_t> held_out;
+    auto start = std::chrono::steady_clock::now();
+    ImplicitALS::PlayMatrix plays = makePlays(users, tracks, plays_per_user, held_out);
+    double generate_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%zu users x %zu tracks, %ld plays (generated in %.1f s), %d factors\n\n",
+                users, tracks, static_cast<long>(plays.nonZeros()), generate_s, config.factors);
+    
+    ImplicitALS als(config);
+    std::printf("iteration   seconds   loss\n");
+    start = std::chrono::steady_clock::now();
+    als.fit(plays, [&](int iteration) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-11d %-9.2f %.4g\n", iteration + 1, seconds, als.loss(plays));
+        start = std::chrono::steady_clock::now();
+    });
+    
+    // Rank every track for a sample of users, skipping their training plays
+    const size_t sample = std::min<size_t>(users, 500);
+    const int k = 50;
+    size_t hits = 0;
+    Eigen::VectorXf scores;
+    for (size_t u = 0; u < sample; ++u) {
+        scores.noalias() = als.getItemFactors().transpose() * als.getUserFactors().col(u);
+        for (ImplicitALS::PlayMatrix::InnerIterator it(plays, u); it; ++it) {
+            scores(it.index()) = -1e30f;
+        }
+        float target = scores(held_out[u]);
+        hits += (scores.array() > target).count() < k;
+    }
+    std::printf("\nhit rate@%d of held-out track: %.3f (random %.4f)\n", k,
+                static_cast<double>(hits) / sample, static_cast<double>(k) / tracks);
+    
+    Eigen::MatrixXd states = Eigen::MatrixXd::Random(8, 4);
+    Eigen::MatrixXd inputs = als.appendUserFeatures(states, {0, 1, 2, static_cast<uint32_t>(users)});
+    std::printf("state features with user factors: %ld rows\n", static_cast<long>(inputs.rows()));
+    return inputs.sum() == 42.0 ? 1 : 0;
+}
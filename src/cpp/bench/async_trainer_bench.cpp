@@ -0,0 +1,68 @@
+#include "music_rl_engine.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace MusicAI;
+
+namespace {
+
+void report(const char* label, std::vector<double>& latencies_us) {
+    std::sort(latencies_us.begin(), latencies_us.end());
+    auto pct = [&](double p) { return latencies_us[static_cast<size_t>(p * (latencies_us.size() - 1))]; };
+    std::cout << label << "  p50 " << pct(0.5) << " us  p99 " << pct(0.99)
+              << " us  max " << latencies_us.back() << " us\n";
+}
+
+} // namespace
+
+// Caller-side latency of DQN::train with inline replay versus background
+// training, plus predict latency while the trainer is busy.
+// Usage: async_trainer_bench [events] [updates_per_event]
+int main(int argc, char** argv) {
+    size_t events = argc > 1 ? std::stoul(argv[1]) : 5000;
+    double ratio = argc > 2 ? std::stod(argv[2]) : 1.0;
+    
+    MusicEnvironment env;
+    std::vector<std::vector<double>> states(events + 1);
+    for (auto& state : states) {
+        state = env.stateToVector(env.reset());
+    }
+    
+    std::vector<double> inline_us, async_us, predict_us;
+    
+    MusicRecommendationDQN inline_dqn;
+    for (size_t i = 0; i < events; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        inline_dqn.train(states[i], static_cast<int>(i % 5), 0.5, states[i + 1], false);
+        inline_us.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    
+    MusicRecommendationDQN async_dqn;
+    AsyncTrainer::Config config;
+    config.updates_per_event = ratio;
+    async_dqn.startBackgroundTraining(config);
+    auto wall_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < events; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        async_dqn.train(states[i], static_cast<int>(i % 5), 0.5, states[i + 1], false);
+        auto mid = std::chrono::steady_clock::now();
+        async_dqn.predict(states[i + 1]);
+        auto end = std::chrono::steady_clock::now();
+        async_us.push_back(std::chrono::duration<double, std::micro>(mid - start).count());
+        predict_us.push_back(std::chrono::duration<double, std::micro>(end - mid).count());
+    }
+    auto stats = async_dqn.getBackgroundTrainingStats();
+    async_dqn.stopBackgroundTraining();
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+    
+    report("train (inline replay):   ", inline_us);
+    report("train (background):      ", async_us);
+    report("predict (background):    ", predict_us);
+    std::cout << "background updates at end of ingestion: " << stats.updates
+              << " (queue depth " << stats.queue_depth << ", " << stats.publishes
+              << " publishes), drained in " << wall_s << " s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+
+namespace MusicAI {
+namespace bench {
+
+// Average wall time of one call to fn over `iterations` calls, in the units
+// of Duration (std::nano, std::micro, std::milli).
+template <typename Duration, typename Fn>
+double timePerCall(int iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, Duration>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+template <typename Fn>
+double timeNs(int iterations, Fn&& fn) {
+    return timePerCall<std::nano>(iterations, fn);
+}
+
+template <typename Fn>
+double timeUs(int iterations, Fn&& fn) {
+    return timePerCall<std::micro>(iterations, fn);
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn&& fn) {
+    return timePerCall<std::milli>(iterations, fn);
+}
+
+} // namespace bench
+} // namespace MusicAI
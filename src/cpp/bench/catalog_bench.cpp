@@ -0,0 +1,79 @@
+#include "track_catalog.h"
+#include "fast_rng.h"
+#include "bench_util.h"
+#include <cstdio>
+#include <string>
+
+using namespace MusicAI;
+using namespace MusicAI::bench;
+
+// Writes a synthetic catalog, maps it, and times the genre and tempo-range
+// scans (plus their intersection) against a plain per-track loop over the
+// same columns, checking both give the same tracks.
+// Usage: catalog_bench [tracks] [path] [embedding_dim]
+int main(int argc, char** argv) {
+    size_t tracks = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    std::string path = argc > 2 ? argv[2] : "catalog_bench.mqtc";
+    int dim = argc > 3 ? std::stoi(argv[3]) : 32;
+    const char* genre_names[] = {"chill_lofi", "pop_hits", "rock_energy", "jazz_smooth", "electronic_dance"};
+    
+    {
+        TrackCatalog::Builder builder(dim);
+        FastRng rng(5);
+        std::vector<float> embedding(dim);
+        for (size_t t = 0; t < tracks; ++t) {
+            for (float& value : embedding) {
+                value = static_cast<float>(rng.uniform() * 2.0 - 1.0);
+            }
+            builder.add(genre_names[rng.below(5)], static_cast<float>(60.0 + 120.0 * rng.uniform()),
+                        static_cast<float>(rng.uniform()), static_cast<float>(rng.uniform()), embedding.data());
+        }
+        builder.write(path);
+    }
+    
+    TrackCatalog catalog = TrackCatalog::open(path);
+    double open_us = timeUs(10, [&]() { TrackCatalog::open(path); });
+    std::printf("%zu tracks, %zu genres, embeddings %dx%zu; open %.1f us\n\n", catalog.size(),
+                catalog.genreNames().size(), catalog.embeddingDim(), catalog.size(), open_us);
+    
+    const int genre = catalog.genreCode("jazz_smooth");
+    const float* tempo = catalog.column(TrackCatalog::Column::TEMPO);
+    const uint8_t* genres = catalog.genreCodes();
+    const int repeats = 50;
+    size_t sink = 0;
+    
+    TrackBitmap scalar_genre(catalog.size());
+    TrackBitmap scalar_tempo(catalog.size());
+    double scalar_genre_us = timeUs(repeats, [&]() {
+        scalar_genre = TrackBitmap(catalog.size());
+        for (size_t i = 0; i < catalog.size(); ++i) {
+            if (genres[i] == genre) {
+                scalar_genre.set(i);
+            }
+        }
+    });
+    double scalar_tempo_us = timeUs(repeats, [&]() {
+        scalar_tempo = TrackBitmap(catalog.size());
+        for (size_t i = 0; i < catalog.size(); ++i) {
+            if (tempo[i] >= 120.0f && tempo[i] <= 130.0f) {
+                scalar_tempo.set(i);
+            }
+        }
+    });
+    
+    TrackBitmap by_genre;
+    TrackBitmap by_tempo;
+    double genre_us = timeUs(repeats, [&]() { by_genre = catalog.filterGenre(genre); });
+    double tempo_us = timeUs(repeats, [&]() { by_tempo = catalog.filterRange(TrackCatalog::Column::TEMPO, 120.0f, 130.0f); });
+    TrackBitmap both = by_genre;
+    double and_us = timeUs(repeats, [&]() { both = by_genre; both &= by_tempo; sink += both.count(); });
+    
+    bool match = by_genre.toIndices() == scalar_genre.toIndices() && by_tempo.toIndices() == scalar_tempo.toIndices();
+    std::printf("scan                  matches    us (scan)   us (per-track loop)\n");
+    std::printf("genre == jazz_smooth  %-10zu %-11.1f %.1f\n", by_genre.count(), genre_us, scalar_genre_us);
+    std::printf("tempo in [120, 130]   %-10zu %-11.1f %.1f\n", by_tempo.count(), tempo_us, scalar_tempo_us);
+    std::printf("both (AND + count)    %-10zu %-11.1f\n", both.count(), and_us);
+    std::printf("results %s\n", match ? "match" : "DIFFER");
+    std::remove(path.c_str());
+    return match && sink != 42 ? 0 : 1;
+}
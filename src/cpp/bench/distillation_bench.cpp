@@ -0,0 +1,100 @@
+#include "distillation.h"
+#include "music_rl_engine.h"
+#include "vectorized_music_environment.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+using namespace MusicAI;
+
+// Latency versus fidelity of students distilled from one teacher. The
+// teacher is a model file, or with "-" the default network pretrained by
+// self-play. Each student is distilled on simulator states, scored on
+// held-out simulator states, saved, and reloaded through the standard
+// loadWeights path.
+// Usage: distillation_bench [teacher_model|-] [distill_states] [output_dir]
+int main(int argc, char** argv) {
+    std::string teacher_path = argc > 1 ? argv[1] : "-";
+    size_t distill_states = argc > 2 ? std::stoul(argv[2]) : 1000000;
+    std::string output_dir = argc > 3 ? argv[3] : ".";
+    
+    NeuralNetwork teacher;
+    if (teacher_path == "-") {
+        MusicRecommendationDQN dqn;
+        VectorizedMusicEnvironment pretrain_env;
+        pretrain_env.pretrain(dqn, 500000);
+        teacher_path = output_dir + "/distillation_teacher.bin";
+        dqn.saveModel(teacher_path);
+    }
+    teacher.loadWeights(teacher_path);
+    
+    VectorizedMusicEnvironment::Config eval_config;
+    eval_config.num_envs = 100000;
+    eval_config.seed = 7;
+    Eigen::MatrixXd eval_states = VectorizedMusicEnvironment(eval_config).observations();
+    
+    auto latency = [&](const NeuralNetwork& network) {
+        // Best of three passes to keep scheduler noise out of the comparison
+        const Eigen::Index samples = 20000;
+        double sink = 0.0;
+        double best_ns = 1e300;
+        for (int pass = 0; pass < 3; ++pass) {
+            auto start = std::chrono::steady_clock::now();
+            for (Eigen::Index i = 0; i < samples; ++i) {
+                sink += network.forward(eval_states.col(i))(0);
+            }
+            best_ns = std::min(best_ns, std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count() / samples);
+        }
+        return sink == 42.0 ? best_ns + 1e-9 : best_ns;
+    };
+    
+    double teacher_ns = latency(teacher);
+    Eigen::MatrixXd teacher_q = teacher.forwardBatch(eval_states, 0);
+    std::vector<size_t> action_counts(NeuralNetwork::OUTPUT_SIZE, 0);
+    for (Eigen::Index i = 0; i < teacher_q.cols(); ++i) {
+        Eigen::Index best;
+        teacher_q.col(i).maxCoeff(&best);
+        ++action_counts[best];
+    }
+    std::cout << "teacher: " << teacher.getLayerCount() - 2 << " hidden layers, "
+              << teacher_ns << " ns/forward, action mix:";
+    for (size_t count : action_counts) {
+        std::cout << " " << 100.0 * count / teacher_q.cols() << "%";
+    }
+    std::cout << "\n";
+    std::cout << "student        params   forward (ns)  speedup  agreement  Q MAE    distill (s)\n";
+    
+    const std::vector<std::vector<int>> students = {{16}, {32}, {32, 16}, {64, 32, 16}};
+    for (const auto& hidden : students) {
+        std::string shape = "8";
+        for (int size : hidden) {
+            shape += "-" + std::to_string(size);
+        }
+        shape += "-5";
+        
+        NeuralNetwork student(hidden, 0.0005);
+        VectorizedMusicEnvironment env;
+        DistillationTrainer trainer(teacher, student);
+        DistillationTrainer::Report report = trainer.distillFromSimulator(env, distill_states);
+        DistillationTrainer::Fidelity fidelity = DistillationTrainer::evaluate(teacher, student, eval_states);
+        
+        size_t params = 0;
+        int inputs = NeuralNetwork::INPUT_SIZE;
+        for (int size : hidden) {
+            params += static_cast<size_t>(size) * (inputs + 1);
+            inputs = size;
+        }
+        params += static_cast<size_t>(NeuralNetwork::OUTPUT_SIZE) * (inputs + 1);
+        
+        std::string path = output_dir + "/student_" + shape + ".bin";
+        student.saveWeights(path);
+        NeuralNetwork reloaded;
+        reloaded.loadWeights(path);
+        double forward_ns = latency(reloaded);
+        
+        std::printf("%-14s %-8zu %-13.1f %-8.2f %-10.2f %-8.4f %.2f\n", shape.c_str(), params, forward_ns,
+                    teacher_ns / forward_ns, 100.0 * fidelity.agreement, fidelity.q_mae, report.seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "sparse_feature_network.h"
+#include "fast_rng.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <tuple>
+
+using namespace MusicAI;
+
+namespace {
+
+// Synthetic listeners: each user prefers one genre, and 70% of their recent
+// tracks come from it. A track's artist and genre follow from its ID.
+struct Catalog {
+    uint64_t users;
+    uint64_t tracks;
+    uint64_t artists;
+    
+    int preferredGenre(uint64_t user) const { return static_cast<int>((user * 2654435761ull >> 7) % 5); }
+    uint64_t artistOf(uint64_t track) const { return track % artists; }
+    
+    // Artists play genre artist % 5
+    uint64_t trackOfGenre(int genre, FastRng& rng) const {
+        uint64_t artist = (rng() % (artists / 5)) * 5 + static_cast<uint64_t>(genre);
+        return artist + artists * (rng() % (tracks / artists));
+    }
+};
+
+void sampleBatch(const Catalog& catalog, size_t n, FastRng& rng, Eigen::MatrixXd& states,
+                 SparseFeatureNetwork::SparseBatch& sparse, std::vector<uint64_t>& users) {
+    states = (Eigen::MatrixXd::Random(NeuralNetwork::INPUT_SIZE, n).array() + 1.0) * 0.5;
+    sparse.assign(3, std::vector<HashedEmbeddingTable::Bag>(n));
+    users.resize(n);
+    for (size_t j = 0; j < n; ++j) {
+        users[j] = rng() % catalog.users;
+        sparse[0][j] = {users[j]};
+        for (int k = 0; k < 3; ++k) {
+            int genre = rng.uniform() < 0.7 ? catalog.preferredGenre(users[j]) : static_cast<int>(rng.below(5));
+            uint64_t track = catalog.trackOfGenre(genre, rng);
+            sparse[1][j].push_back(track);
+            sparse[2][j].push_back(catalog.artistOf(track));
+        }
+    }
+}
+
+} // namespace
+
+// Contextual-bandit check of the sparse feature path: reward 1 for the
+// listener's preferred genre. Trains with and without embeddings, reports
+// greedy accuracy and step time, then step time against table size.
+// Usage: embedding_bench [steps] [batch] [users]
+int main(int argc, char** argv) {
+    int steps = argc > 1 ? std::stoi(argv[1]) : 3000;
+    size_t batch = argc > 2 ? std::stoul(argv[2]) : 64;
+    Catalog catalog{argc > 3 ? std::stoull(argv[3]) : 5000, 1000000, 10000};
+    
+    auto run = [&](const SparseFeatureNetwork::Config& config, bool use_sparse, int num_steps) {
+        SparseFeatureNetwork model(config);
+        FastRng rng(11);
+        Eigen::MatrixXd states;
+        SparseFeatureNetwork::SparseBatch sparse;
+        std::vector<uint64_t> users;
+        std::vector<int> actions(batch);
+        Eigen::MatrixXd targets(1, batch);
+        
+        auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < num_steps; ++step) {
+            sampleBatch(catalog, batch, rng, states, sparse, users);
+            if (!use_sparse) {
+                for (auto& bags : sparse) {
+                    for (auto& bag : bags) {
+                        bag.clear();
+                    }
+                }
+            }
+            for (size_t j = 0; j < batch; ++j) {
+                actions[j] = static_cast<int>(rng.below(5));
+                targets(0, j) = actions[j] == catalog.preferredGenre(users[j]) ? 1.0 : 0.0;
+            }
+            model.trainBatch(states, sparse, actions, targets);
+        }
+        double step_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / num_steps;
+        
+        sampleBatch(catalog, 2000, rng, states, sparse, users);
+        if (!use_sparse) {
+            for (auto& bags : sparse) {
+                for (auto& bag : bags) {
+                    bag.clear();
+                }
+            }
+        }
+        Eigen::MatrixXd q = model.forwardBatch(states, sparse);
+        int hits = 0;
+        for (Eigen::Index j = 0; j < q.cols(); ++j) {
+            Eigen::Index best;
+            q.col(j).maxCoeff(&best);
+            hits += static_cast<int>(best) == catalog.preferredGenre(users[j]);
+        }
+        size_t trained = 0;
+        for (size_t f = 0; f < model.numFields(); ++f) {
+            trained += model.getTable(f).trainedBuckets();
+        }
+        return std::make_tuple(static_cast<double>(hits) / q.cols(), step_us, trained);
+    };
+    
+    SparseFeatureNetwork::Config config;
+    config.learning_rate = 0.01;
+    for (bool use_sparse : {false, true}) {
+        auto [accuracy, step_us, trained] = run(config, use_sparse, steps);
+        std::printf("%-18s greedy = preferred genre %.1f%%, %.1f us/step, %zu buckets trained\n",
+                    use_sparse ? "dense + embeddings" : "dense only", accuracy * 100.0, step_us, trained);
+    }
+    
+    std::printf("\nbuckets per table   us/step\n");
+    for (size_t buckets : {size_t(1) << 12, size_t(1) << 16, size_t(1) << 20, size_t(1) << 22}) {
+        config.fields = SparseFeatureNetwork::defaultFields();
+        for (auto& field : config.fields) {
+            field.table.buckets = buckets;
+        }
+        std::printf("%-19zu %.1f\n", buckets, std::get<1>(run(config, true, 500)));
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "exploration_policy.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace MusicAI;
+
+// Action selection cost: the old per-call random_device + mt19937 epsilon-greedy
+// against the batched policies driven by one seeded FastRng.
+// Usage: exploration_bench [iterations] [batch]
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 200000;
+    int batch = argc > 2 ? std::stoi(argv[2]) : 256;
+    const double epsilon = 0.1;
+    
+    Eigen::VectorXd q_single = Eigen::VectorXd::Random(5);
+    Eigen::MatrixXd q_batch = Eigen::MatrixXd::Random(5, batch);
+    long sink = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_real_distribution<double> dis(0.0, 1.0);
+        if (dis(gen) < epsilon) {
+            sink += std::uniform_int_distribution<int>(0, 4)(gen);
+        } else {
+            Eigen::Index best;
+            q_single.maxCoeff(&best);
+            sink += best;
+        }
+    }
+    double legacy_ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / iterations;
+    std::cout << "per-call mt19937 epsilon-greedy: " << legacy_ns << " ns/decision\n";
+    
+    const char* names[] = {"epsilon-greedy", "boltzmann", "ucb"};
+    std::cout << "policy            single (ns)   batched (ns/sample)\n";
+    for (int type = 0; type < 3; ++type) {
+        ExplorationConfig config;
+        config.type = static_cast<ExplorationType>(type);
+        ExplorationPolicy policy(config);
+        FastRng rng(42);
+        
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sink += policy.selectAction(q_single, epsilon, rng);
+        }
+        double single_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / iterations;
+        
+        std::vector<int> actions;
+        int batches = std::max(1, iterations / batch);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < batches; ++i) {
+            policy.selectActions(q_batch, epsilon, rng, actions);
+            sink += actions[0];
+        }
+        double batch_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / (static_cast<double>(batches) * batch);
+        
+        std::cout.width(18);
+        std::cout << std::left << names[type];
+        std::cout.width(14);
+        std::cout << single_ns << batch_ns << (sink == 42 ? " " : "") << "\n";
+    }
+    return 0;
+}
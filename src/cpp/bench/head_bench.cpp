@@ -0,0 +1,46 @@
+#include "neural_network.h"
+#include <chrono>
+#include <iostream>
+
+using namespace MusicAI;
+
+// Inference cost per output head type: single-sample forward (the predict
+// path) and batched forwardBatch, for the default 8-64-32-16 trunk.
+// Usage: head_bench [iterations] [batch]
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 200000;
+    int batch = argc > 2 ? std::stoi(argv[2]) : 256;
+    
+    const char* names[] = {"linear Q", "dueling", "C51 (51 atoms)"};
+    Eigen::VectorXd input = Eigen::VectorXd::Random(NeuralNetwork::INPUT_SIZE);
+    Eigen::MatrixXd inputs = Eigen::MatrixXd::Random(NeuralNetwork::INPUT_SIZE, batch);
+    
+    std::cout << "head              single (ns)   batched (ns/sample)\n";
+    for (int type = 0; type < 3; ++type) {
+        HeadConfig config;
+        config.type = static_cast<HeadType>(type);
+        NeuralNetwork network(0.001, config);
+        
+        double sink = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            sink += network.forward(input)(0);
+        }
+        double single_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / iterations;
+        
+        int batches = std::max(1, iterations / batch);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < batches; ++i) {
+            sink += network.forwardBatch(inputs)(0, 0);
+        }
+        double batch_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / (static_cast<double>(batches) * batch);
+        
+        std::cout.width(18);
+        std::cout << std::left << names[type];
+        std::cout.width(14);
+        std::cout << single_ns << batch_ns << (sink == 42.0 ? " " : "") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "per_user_networks.h"
+#include "bench_util.h"
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace MusicAI;
+using namespace MusicAI::bench;
+
+// Heterogeneous batches of per-user requests: one NeuralNetwork::forward per
+// request (with and without the fixed-size trunk kernels) versus one
+// PerUserNetworks::evaluate over the arena.
+// Baseline networks are shared round-robin from a pool so the process stays
+// small at large user counts.
+// Usage: per_user_bench [users] [batch] [iterations] [architecture]
+int main(int argc, char** argv) {
+    size_t num_users = argc > 1 ? std::stoul(argv[1]) : 10000;
+    size_t batch = argc > 2 ? std::stoul(argv[2]) : 4096;
+    int iterations = argc > 3 ? std::stoi(argv[3]) : 20;
+    NeuralNetwork::Architecture architecture =
+        NeuralNetwork::Architecture::parse(argc > 4 ? argv[4] : "8-64-32-16-5");
+    const size_t pool_size = std::min<size_t>(num_users, 4096);
+    
+    std::vector<std::unique_ptr<NeuralNetwork>> pool;
+    for (size_t i = 0; i < pool_size; ++i) {
+        pool.push_back(std::make_unique<NeuralNetwork>(architecture));
+    }
+    PerUserNetworks per_user(*pool[0]);
+    for (size_t u = 0; u < num_users; ++u) {
+        per_user.setUser(u, *pool[u % pool_size]);
+    }
+    
+    std::mt19937_64 gen(5);
+    std::uniform_int_distribution<uint64_t> pick(0, num_users - 1);
+    std::vector<uint64_t> users(batch);
+    for (auto& user : users) {
+        user = pick(gen);
+    }
+    Eigen::MatrixXd states = (Eigen::MatrixXd::Random(NeuralNetwork::INPUT_SIZE, batch).array() + 1.0) * 0.5;
+    
+    Eigen::MatrixXd reference(NeuralNetwork::OUTPUT_SIZE, batch);
+    double separate = timeNs(iterations, [&]() {
+        for (size_t i = 0; i < batch; ++i) {
+            reference.col(i) = pool[users[i] % pool_size]->forward(states.col(i));
+        }
+    }) / batch;
+    
+    for (auto& network : pool) {
+        network->setFixedSizeKernels(false);
+    }
+    double dynamic = timeNs(iterations, [&]() {
+        for (size_t i = 0; i < batch; ++i) {
+            reference.col(i) = pool[users[i] % pool_size]->forward(states.col(i));
+        }
+    }) / batch;
+    
+    Eigen::MatrixXd q_values;
+    double per_user_ns = timeNs(iterations, [&]() { per_user.evaluate(users, states, q_values); }) / batch;
+    double diff = (q_values - reference).cwiseAbs().maxCoeff();
+    
+    std::printf("%s, %zu users (%zu doubles each), batch %zu\n", architecture.toString().c_str(),
+                num_users, per_user.parametersPerUser(), batch);
+    std::printf("forward, fixed-size kernel  %.1f ns/request\n", separate);
+    std::printf("forward, dynamic sizes      %.1f ns/request\n", dynamic);
+    std::printf("per-user arena              %.1f ns/request (%.2fx fixed, %.2fx dynamic)\n",
+                per_user_ns, separate / per_user_ns, dynamic / per_user_ns);
+    std::printf("max |diff|                  %.2e\n", diff);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "playlist_builder.h"
+#include "track_index.h"
+#include "fast_rng.h"
+#include "bench_util.h"
+#include <cstdio>
+#include <set>
+#include <string>
+
+using namespace MusicAI;
+using namespace MusicAI::bench;
+
+// End-to-end playlist generation: writes and maps a synthetic catalog,
+// indexes it, retrieves a genre-conditioned candidate pool around a taste
+// vector, then times beam search against greedy (beam width 1).
+// Usage: playlist_bench [tracks] [candidates_per_genre] [length] [beam_width] [path]
+int main(int argc, char** argv) {
+    size_t tracks = argc > 1 ? std::stoul(argv[1]) : 200000;
+    int per_genre = argc > 2 ? std::stoi(argv[2]) : 200;
+    int length = argc > 3 ? std::stoi(argv[3]) : 50;
+    int beam_width = argc > 4 ? std::stoi(argv[4]) : 8;
+    std::string path = argc > 5 ? argv[5] : "playlist_bench.mqtc";
+    const int dim = 32;
+    
+    {
+        TrackCatalog::Builder builder(dim);
+        FastRng rng(3);
+        std::vector<float> embedding(dim);
+        for (size_t t = 0; t < tracks; ++t) {
+            for (float& value : embedding) {
+                value = static_cast<float>(rng.uniform() * 2.0 - 1.0);
+            }
+            auto genre = static_cast<MusicEnvironment::Action>(rng.below(5));
+            builder.add(MusicEnvironment::actionToString(genre), static_cast<float>(60.0 + 120.0 * rng.uniform()),
+                        static_cast<float>(rng.uniform()), static_cast<float>(rng.uniform()), embedding.data());
+        }
+        builder.write(path);
+    }
+    TrackCatalog catalog = TrackCatalog::open(path);
+    
+    // Index genres are actions; catalog codes follow first appearance
+    std::vector<int> code_action(catalog.genreNames().size());
+    for (int action = 0; action < 5; ++action) {
+        code_action[catalog.genreCode(MusicEnvironment::actionToString(static_cast<MusicEnvironment::Action>(action)))] = action;
+    }
+    std::vector<uint8_t> genres(catalog.size());
+    for (size_t t = 0; t < catalog.size(); ++t) {
+        genres[t] = static_cast<uint8_t>(code_action[catalog.genreCodes()[t]]);
+    }
+    TrackIndex::Config index_config;
+    index_config.num_lists = 256;
+    TrackIndex index(index_config);
+    index.build(catalog.embeddings(), genres);
+    
+    Eigen::MatrixXf queries(dim, 5);
+    queries.colwise() = catalog.embeddings().col(0);
+    std::vector<int> query_genres = {0, 1, 2, 3, 4};
+    std::vector<std::vector<TrackIndex::Neighbor>> neighbors;
+    double retrieve_ms = timeMs(20, [&]() { index.search(queries, query_genres, per_genre, 8, neighbors); });
+    std::vector<PlaylistBuilder::Candidate> candidates;
+    for (const auto& genre_neighbors : neighbors) {
+        for (const auto& neighbor : genre_neighbors) {
+            candidates.push_back({neighbor.track, -neighbor.distance / dim});
+        }
+    }
+    
+    NeuralNetwork network{NeuralNetwork::Architecture()};
+    MusicEnvironment environment;
+    MusicEnvironment::State context = environment.reset();
+    std::printf("%zu tracks, %zu candidates (retrieval %.2f ms), %d-track playlists\n\n",
+                catalog.size(), candidates.size(), retrieve_ms, length);
+    
+    std::printf("beam width   ms/playlist   score     distinct tracks   genre switches\n");
+    double sink = 0.0;
+    for (int width : {1, beam_width}) {
+        PlaylistBuilder::Config config;
+        config.beam_width = width;
+        PlaylistBuilder builder(network, catalog, config);
+        PlaylistBuilder::Playlist playlist;
+        double ms = timeMs(20, [&]() { playlist = builder.build(context, candidates, length); });
+        int switches = 0;
+        for (size_t i = 1; i < playlist.genres.size(); ++i) {
+            switches += playlist.genres[i] != playlist.genres[i - 1];
+        }
+        std::printf("%-12d %-13.2f %-9.3f %-17zu %d\n", width, ms, playlist.score,
+                    std::set<uint32_t>(playlist.tracks.begin(), playlist.tracks.end()).size(), switches);
+        sink += playlist.score;
+    }
+    std::remove(path.c_str());
+    return sink == 42.0 ? 1 : 0;
+}
@@ -0,0 +1,142 @@
+#include "music_rl_engine.h"
+#include "policy_table.h"
+#include "vectorized_music_environment.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+using namespace MusicAI;
+
+// Distills a network into policy tables at several grid resolutions and
+// reports table size against agreement with the full network on states
+// drawn from the simulator, overall and per teacher action so a skewed
+// policy cannot hide behind its majority action. With no model file, a
+// network is pretrained by self-play from a fixed seed first, so runs are
+// comparable. Optionally saves the default-grid table.
+// Usage: policy_table_bench [model_file|-] [eval_states] [output_table]
+int main(int argc, char** argv) {
+    std::string model_path = argc > 1 ? argv[1] : "-";
+    size_t eval_states = argc > 2 ? std::stoul(argv[2]) : 100000;
+    std::string output_path = argc > 3 ? argv[3] : "";
+    
+    NeuralNetwork network;
+    if (model_path == "-") {
+        MusicRecommendationDQN dqn(NeuralNetwork::Architecture(), 0.001, 1.0, 0.995, 0.01, 0.95,
+                                   MusicRecommendationDQN::DEFAULT_SEED);
+        VectorizedMusicEnvironment::Config pretrain_config;
+        pretrain_config.seed = 1;
+        VectorizedMusicEnvironment pretrain_env(pretrain_config);
+        pretrain_env.pretrain(dqn, 500000);
+        model_path = "policy_table_bench_model.bin";
+        dqn.saveModel(model_path);
+        network.loadWeights(model_path);
+        std::remove(model_path.c_str());
+    } else {
+        network.loadWeights(model_path);
+    }
+    
+    VectorizedMusicEnvironment::Config env_config;
+    env_config.num_envs = eval_states;
+    env_config.seed = 7;
+    VectorizedMusicEnvironment env(env_config);
+    Eigen::MatrixXd states = env.observations();
+    Eigen::MatrixXd reference_q = network.forwardBatch(states, 0);
+    std::vector<int> reference(states.cols());
+    for (Eigen::Index i = 0; i < states.cols(); ++i) {
+        Eigen::Index best;
+        reference_q.col(i).maxCoeff(&best);
+        reference[i] = static_cast<int>(best);
+    }
+    
+    std::vector<size_t> action_counts(PolicyTable::NUM_ACTIONS, 0);
+    for (int action : reference) {
+        ++action_counts[action];
+    }
+    std::cout << "network action mix on " << states.cols() << " states:";
+    for (size_t count : action_counts) {
+        std::cout << " " << 100.0 * count / states.cols() << "%";
+    }
+    std::cout << "\n";
+    
+    struct Variant {
+        const char* name;
+        int temperature, hour, history;
+    };
+    const Variant variants[] = {
+        {"coarse", 2, 4, 3},
+        {"default", 4, 6, 5},
+        {"fine", 8, 12, 5},
+    };
+    
+    std::cout << "grid      cells      actions (KB)  +fp16 Q (KB)  build (ms)  agreement  Q MAE    lookup (ns)\n";
+    for (const Variant& variant : variants) {
+        PolicyTable::Grid grid;
+        grid.axes[0].levels = variant.temperature;
+        grid.axes[2] = {0.0, (variant.hour - 1) / static_cast<double>(variant.hour), variant.hour};
+        for (int h = 5; h < 8; ++h) {
+            grid.axes[h].levels = variant.history;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        PolicyTable table = PolicyTable::build(network, grid, true);
+        double build_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        size_t agree = 0;
+        std::vector<size_t> agree_by_action(PolicyTable::NUM_ACTIONS, 0);
+        double q_error = 0.0;
+        for (Eigen::Index i = 0; i < states.cols(); ++i) {
+            Eigen::VectorXd state = states.col(i);
+            bool match = table.action(state) == reference[i];
+            agree += match;
+            agree_by_action[reference[i]] += match;
+            q_error += (table.qValues(state) - reference_q.col(i)).cwiseAbs().mean();
+        }
+        
+        long sink = 0;
+        start = std::chrono::steady_clock::now();
+        for (Eigen::Index i = 0; i < states.cols(); ++i) {
+            sink += table.action(states.col(i).data());
+        }
+        double lookup_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count() / states.cols();
+        
+        size_t action_bytes = table.cells();
+        size_t q_bytes = table.cells() * PolicyTable::NUM_ACTIONS * sizeof(Eigen::half);
+        std::printf("%-9s %-10zu %-13.1f %-13.1f %-11.1f %-10.2f %-8.4f %.1f%s\n",
+                    variant.name, table.cells(), action_bytes / 1024.0, (action_bytes + q_bytes) / 1024.0,
+                    build_ms, 100.0 * agree / states.cols(), q_error / states.cols(), lookup_ns,
+                    sink == -1 ? " " : "");
+        std::cout << "          per teacher action:";
+        for (int a = 0; a < PolicyTable::NUM_ACTIONS; ++a) {
+            if (action_counts[a] == 0) {
+                std::cout << " -";
+            } else {
+                std::printf(" %.2f%%", 100.0 * agree_by_action[a] / action_counts[a]);
+            }
+        }
+        std::cout << "\n";
+        
+        if (!output_path.empty() && std::string(variant.name) == "default") {
+            table.save(output_path);
+            PolicyTable mapped = PolicyTable::load(output_path);
+            std::cout << "saved " << output_path << " (" << mapped.sizeBytes() << " bytes, mapped back "
+                      << (mapped.action(states.col(0)) == table.action(states.col(0)) ? "ok" : "MISMATCH")
+                      << ")\n";
+        }
+    }
+    
+    double forward_ns;
+    {
+        double sink = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (Eigen::Index i = 0; i < std::min<Eigen::Index>(states.cols(), 20000); ++i) {
+            sink += network.forward(states.col(i))(0);
+        }
+        forward_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                     std::min<Eigen::Index>(states.cols(), 20000);
+        if (sink == 42.0) std::cout << " ";
+    }
+    std::cout << "full network forward: " << forward_ns << " ns/state\n";
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include "music_environment.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+using namespace MusicAI;
+
+// Compares scalar calculateReward against calculateRewardBatch on random
+// states: checks bit-identical results and reports throughput.
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    
+    MusicEnvironment env;
+    MusicEnvironment::StateBatch states;
+    states.resize(n);
+    std::vector<int> actions(n);
+    std::vector<double> ratings(n);
+    
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> action_dist(0, 4);
+    std::uniform_real_distribution<double> rating_dist(0.0, 5.0);
+    for (size_t i = 0; i < n; ++i) {
+        states.set(i, env.reset());
+        actions[i] = action_dist(rng);
+        ratings[i] = rating_dist(rng);
+    }
+    
+    std::vector<double> scalar(n), batch;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        scalar[i] = env.calculateReward(MusicEnvironment::intToAction(actions[i]),
+                                        states.get(i), ratings[i]);
+    }
+    auto mid = std::chrono::steady_clock::now();
+    env.calculateRewardBatch(states, actions, ratings, batch);
+    auto end = std::chrono::steady_clock::now();
+    
+    bool identical = std::memcmp(scalar.data(), batch.data(), n * sizeof(double)) == 0;
+    double scalar_ms = std::chrono::duration<double, std::milli>(mid - start).count();
+    double batch_ms = std::chrono::duration<double, std::milli>(end - mid).count();
+    
+    std::cout << "states:        " << n << "\n"
+              << "scalar:        " << scalar_ms << " ms (" << n / scalar_ms / 1e3 << " M/s)\n"
+              << "batch:         " << batch_ms << " ms (" << n / batch_ms / 1e3 << " M/s)\n"
+              << "bit-identical: " << (identical ? "yes" : "NO") << std::endl;
+    return identical ? 0 : 1;
+}
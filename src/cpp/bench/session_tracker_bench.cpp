@@ -0,0 +1,73 @@
+#include "music_rl_engine.h"
+#include "session_tracker.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace MusicAI;
+
+// Cost of session-aware transition assembly on the training hot path:
+// raw SessionTracker::observe throughput over many interleaved listeners,
+// then end-to-end DQN::observe against the stateless DQN::train.
+// Usage: session_tracker_bench [sessions] [events]
+int main(int argc, char** argv) {
+    size_t num_sessions = argc > 1 ? std::stoul(argv[1]) : 100000;
+    size_t num_events = argc > 2 ? std::stoul(argv[2]) : 2000000;
+    
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<uint64_t> session_dist(0, num_sessions - 1);
+    std::vector<uint64_t> session_ids(num_events);
+    for (auto& id : session_ids) {
+        id = session_dist(rng);
+    }
+    
+    MusicEnvironment env;
+    std::vector<Eigen::VectorXd> states(256);
+    for (auto& state : states) {
+        auto vec = env.stateToVector(env.reset());
+        state = Eigen::Map<Eigen::VectorXd>(vec.data(), vec.size());
+    }
+    
+    SessionTracker::Config config;
+    config.expected_sessions = num_sessions;
+    SessionTracker tracker(config);
+    std::vector<Experience> out;
+    out.reserve(4);
+    size_t emitted = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_events; ++i) {
+        tracker.observe(session_ids[i], states[i & 255], static_cast<int>(i % 5), 0.5,
+                        static_cast<double>(i) * 1e-3, out);
+        emitted += out.size();
+        out.clear();
+    }
+    double tracker_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    // End-to-end, including replay training, on a smaller event count and
+    // fewer listeners so most events complete a transition
+    size_t dqn_events = std::min<size_t>(num_events, 20000);
+    size_t dqn_sessions = std::min<size_t>(num_sessions, 1000);
+    std::vector<double> state_vec(8, 0.5);
+    MusicRecommendationDQN stateless, session_aware;
+    
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < dqn_events; ++i) {
+        stateless.train(state_vec, static_cast<int>(i % 5), 0.5, state_vec, false);
+    }
+    double train_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < dqn_events; ++i) {
+        session_aware.observe(session_ids[i] % dqn_sessions, state_vec, static_cast<int>(i % 5), 0.5,
+                              static_cast<double>(i) * 1e-3);
+    }
+    double observe_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::cout << "sessions:              " << num_sessions << "\n"
+              << "tracker events:        " << num_events << " (" << emitted << " transitions)\n"
+              << "tracker observe:       " << tracker_s * 1e9 / num_events << " ns/event\n"
+              << "DQN train (stateless): " << train_s * 1e6 / dqn_events << " us/event\n"
+              << "DQN observe (session): " << observe_s * 1e6 / dqn_events << " us/event" << std::endl;
+    return 0;
+}
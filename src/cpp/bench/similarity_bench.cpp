@@ -0,0 +1,112 @@
+#include "item_similarity.h"
+#include "fast_rng.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+using namespace MusicAI;
+
+namespace {
+
+// Sessions draw most tracks from one of 256 taste groups, with play counts 1-4
+ItemSimilarity::SessionMatrix makeSessions(size_t sessions, size_t tracks, int length) {
+    FastRng rng(21);
+    const size_t groups = 256;
+    const size_t group_size = tracks / groups;
+    ItemSimilarity::SessionMatrix matrix(sessions, tracks);
+    matrix.reserve(Eigen::VectorXi::Constant(sessions, length));
+    std::vector<uint32_t> row;
+    for (size_t s = 0; s < sessions; ++s) {
+        size_t group = rng() % groups;
+        row.clear();
+        for (int p = 0; p < length; ++p) {
+            row.push_back(static_cast<uint32_t>(rng.uniform() < 0.8 ? group * group_size + rng() % group_size
+                                                                   : rng() % tracks));
+        }
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        for (uint32_t track : row) {
+            matrix.insert(s, track) = static_cast<float>(1 + rng() % 4);
+        }
+    }
+    matrix.makeCompressed();
+    return matrix;
+}
+
+double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+// Top-k cosine and Jaccard neighbours from a synthetic session x track
+// matrix, against Eigen's single-threaded X^T X product (materialized, then
+// scored) as the baseline and reference for a sample of rows.
+// Usage: similarity_bench [sessions] [tracks] [session_length] [k] [threads] [compare 0|1]
+int main(int argc, char** argv) {
+    size_t num_sessions = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t tracks = argc > 2 ? std::stoul(argv[2]) : 50000;
+    int length = argc > 3 ? std::stoi(argv[3]) : 20;
+    ItemSimilarity::Config config;
+    config.top_k = argc > 4 ? std::stoi(argv[4]) : 20;
+    config.num_threads = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 0;
+    bool compare = argc > 6 ? std::stoi(argv[6]) != 0 : true;
+    
+    ItemSimilarity::SessionMatrix sessions = makeSessions(num_sessions, tracks, length);
+    std::printf("%zu sessions x %zu tracks, %ld plays, top-%d\n\n", num_sessions, tracks,
+                static_cast<long>(sessions.nonZeros()), config.top_k);
+    
+    auto start = std::chrono::steady_clock::now();
+    ItemSimilarity cosine = ItemSimilarity::compute(sessions, config);
+    double cosine_s = seconds(start);
+    config.measure = ItemSimilarity::Measure::JACCARD;
+    start = std::chrono::steady_clock::now();
+    ItemSimilarity jaccard = ItemSimilarity::compute(sessions, config);
+    double jaccard_s = seconds(start);
+    std::printf("row-wise top-k, cosine:   %.2f s, %ld neighbours kept\n", cosine_s,
+                static_cast<long>(cosine.toSparseMatrix().nonZeros()));
+    std::printf("row-wise top-k, jaccard:  %.2f s\n", jaccard_s);
+    
+    int mismatches = 0;
+    if (compare) {
+        start = std::chrono::steady_clock::now();
+        Eigen::SparseMatrix<float> columns = sessions;
+        Eigen::SparseMatrix<float> product = Eigen::SparseMatrix<float>(columns.transpose()) * columns;
+        double product_s = seconds(start);
+        std::printf("Eigen X^T X (materialized): %.2f s, %ld entries, %.0f MB\n", product_s,
+                    static_cast<long>(product.nonZeros()),
+                    product.nonZeros() * (sizeof(float) + sizeof(int)) / 1048576.0);
+        
+        // Exact cosine top-k from the product for a sample of tracks
+        Eigen::VectorXf diagonal = product.diagonal();
+        for (size_t i = 0; i < std::min<size_t>(tracks, 200); ++i) {
+            std::vector<ItemSimilarity::Neighbor> exact;
+            for (Eigen::SparseMatrix<float>::InnerIterator it(product, static_cast<Eigen::Index>(i)); it; ++it) {
+                if (static_cast<size_t>(it.index()) != i) {
+                    exact.push_back({static_cast<uint32_t>(it.index()),
+                                     it.value() / std::sqrt(diagonal(i) * diagonal(it.index()))});
+                }
+            }
+            std::sort(exact.begin(), exact.end(), [](const auto& a, const auto& b) {
+                return a.similarity > b.similarity || (a.similarity == b.similarity && a.track < b.track);
+            });
+            exact.resize(std::min<size_t>(exact.size(), config.top_k));
+            const auto* found = cosine.neighbors(static_cast<uint32_t>(i));
+            for (size_t r = 0; r < exact.size(); ++r) {
+                mismatches += std::abs(found[r].similarity - exact[r].similarity) > 1e-5f;
+            }
+            mismatches += exact.size() != cosine.numNeighbors(static_cast<uint32_t>(i));
+        }
+        std::printf("cosine top-k vs product on 200 tracks: %d mismatches\n", mismatches);
+    }
+    
+    const auto* similar = cosine.neighbors(0);
+    std::printf("\nmore like track 0:");
+    for (size_t r = 0; r < std::min<size_t>(5, cosine.numNeighbors(0)); ++r) {
+        std::printf(" %u (%.3f)", similar[r].track, similar[r].similarity);
+    }
+    std::printf("\n");
+    return mismatches == 0 ? 0 : 1;
+}
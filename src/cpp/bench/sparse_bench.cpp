@@ -0,0 +1,66 @@
+#include "neural_network.h"
+#include "bench_util.h"
+#include <cstdio>
+#include <random>
+#include <Eigen/Sparse>
+
+using namespace MusicAI;
+using namespace MusicAI::bench;
+
+// Dense versus compressed-sparse (row-major) kernels for the trunk layer
+// shapes at decreasing density, for a single state and a batch, followed
+// by single-state forward of the whole network at several pruning levels.
+// Usage: sparse_bench [iterations] [batch]
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 100000;
+    int batch = argc > 2 ? std::stoi(argv[2]) : 256;
+    
+    const int shapes[][2] = {{64, 8}, {32, 64}, {16, 32}};
+    const double densities[] = {1.0, 0.5, 0.3, 0.2, 0.1, 0.05};
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    double sink = 0.0;
+    
+    std::printf("layer    density  dense x1 (ns)  sparse x1 (ns)  dense xB (ns/col)  sparse xB (ns/col)\n");
+    for (const auto& shape : shapes) {
+        for (double density : densities) {
+            Eigen::MatrixXd dense = Eigen::MatrixXd::Random(shape[0], shape[1]);
+            for (Eigen::Index j = 0; j < dense.size(); ++j) {
+                if (unit(gen) >= density) {
+                    dense(j) = 0.0;
+                }
+            }
+            Eigen::SparseMatrix<double, Eigen::RowMajor> sparse = dense.sparseView();
+            sparse.makeCompressed();
+            
+            Eigen::VectorXd x = Eigen::VectorXd::Random(shape[1]);
+            Eigen::MatrixXd xb = Eigen::MatrixXd::Random(shape[1], batch);
+            Eigen::VectorXd y(shape[0]);
+            Eigen::MatrixXd yb(shape[0], batch);
+            int batch_iterations = std::max(1, iterations / batch * 4);
+            
+            double dense_one = timeNs(iterations, [&]() { y.noalias() = dense * x; sink += y(0); });
+            double sparse_one = timeNs(iterations, [&]() { y.noalias() = sparse * x; sink += y(0); });
+            double dense_batch = timeNs(batch_iterations, [&]() { yb.noalias() = dense * xb; sink += yb(0); }) / batch;
+            double sparse_batch = timeNs(batch_iterations, [&]() { yb.noalias() = sparse * xb; sink += yb(0); }) / batch;
+            
+            std::printf("%2dx%-5d %-8.2f %-14.1f %-15.1f %-18.2f %.2f\n", shape[0], shape[1],
+                        static_cast<double>(sparse.nonZeros()) / dense.size(),
+                        dense_one, sparse_one, dense_batch, sparse_batch);
+        }
+    }
+    
+    Eigen::VectorXd input = Eigen::VectorXd::Random(NeuralNetwork::INPUT_SIZE);
+    std::printf("\nnetwork forward (ns)   dense    sparse layers\n");
+    for (double sparsity : {0.0, 0.5, 0.8, 0.9, 0.95}) {
+        NeuralNetwork network;
+        if (sparsity > 0.0) {
+            network.pruneByMagnitude(sparsity);
+        }
+        double dense = timeNs(iterations, [&]() { sink += network.forward(input)(0); });
+        network.setSparseInference(1.0);
+        double sparse = timeNs(iterations, [&]() { sink += network.forward(input)(0); });
+        std::printf("pruned %-4.0f%%           %-8.1f %.1f\n", sparsity * 100.0, dense, sparse);
+    }
+    return sink == 42.0 ? 1 : 0;
+}
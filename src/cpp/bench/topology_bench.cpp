@@ -0,0 +1,46 @@
+#include "neural_network.h"
+#include "fixed_trunk.h"
+#include "bench_util.h"
+#include <cstdio>
+#include <string>
+
+using namespace MusicAI;
+using namespace MusicAI::bench;
+
+// Single-state forward with the pre-instantiated fixed-size trunk kernels
+// versus the dynamic-size layer loop, for every registered topology, plus a
+// save/load round trip of the architecture descriptor.
+// Usage: topology_bench [iterations]
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::stoi(argv[1]) : 200000;
+    Eigen::VectorXd input = Eigen::VectorXd::Random(NeuralNetwork::INPUT_SIZE);
+    double sink = 0.0;
+    
+    std::printf("architecture        dynamic (ns)  fixed (ns)  speedup  max |diff|\n");
+    for (const auto& hidden_sizes : fixedTrunkTopologies()) {
+        NeuralNetwork network(hidden_sizes);
+        network.setFixedSizeKernels(false);
+        Eigen::VectorXd reference = network.forward(input);
+        double dynamic = timeNs(iterations, [&]() { sink += network.forward(input)(0); });
+        
+        network.setFixedSizeKernels(true);
+        double diff = (network.forward(input) - reference).cwiseAbs().maxCoeff();
+        double fixed = timeNs(iterations, [&]() { sink += network.forward(input)(0); });
+        
+        std::printf("%-19s %-13.1f %-11.1f %-8.2f %.2e%s\n", network.getArchitecture().toString().c_str(),
+                    dynamic, fixed, dynamic / fixed, diff,
+                    network.usesFixedSizeKernel() ? "" : "  (no kernel)");
+    }
+    
+    NeuralNetwork::Architecture architecture = NeuralNetwork::Architecture::parse("8-48:tanh-24-5:dueling");
+    NeuralNetwork saved(architecture);
+    const std::string path = "topology_bench.model";
+    saved.saveWeights(path);
+    NeuralNetwork loaded;
+    loaded.loadWeights(path);
+    std::remove(path.c_str());
+    std::printf("\nround trip %s -> %s, max |diff| %.2e\n", architecture.toString().c_str(),
+                loaded.getArchitecture().toString().c_str(),
+                (saved.forward(input) - loaded.forward(input)).cwiseAbs().maxCoeff());
+    return sink == 42.0 ? 1 : 0;
+}
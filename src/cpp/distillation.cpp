@@ -0,0 +1,128 @@
+#include "distillation.h"
+#include "vectorized_music_environment.h"
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+
+namespace MusicAI {
+
+DistillationTrainer::DistillationTrainer(const NeuralNetwork& teacher, NeuralNetwork& student,
+                                         const Config& config)
+    : teacher_(teacher), student_(student), config_(config), rng_(config.seed) {
+    if (config_.minibatch == 0 || config_.epochs < 1) {
+        throw std::invalid_argument("Distillation needs a positive minibatch size and epoch count");
+    }
+    if (teacher.getHead().numActions() != student.getHead().numActions()) {
+        throw std::invalid_argument("Teacher and student must have the same number of actions");
+    }
+}
+
+double DistillationTrainer::distillBatch(const Eigen::MatrixXd& states, Report& report) {
+    if (states.cols() == 0) {
+        return 0.0;
+    }
+    return fitStudent(states, teacher_.forwardBatch(states, config_.num_threads), report);
+}
+
+double DistillationTrainer::fitStudent(const Eigen::MatrixXd& states, const Eigen::MatrixXd& targets,
+                                       Report& report) {
+    Eigen::Index n = states.cols();
+    order_.resize(n);
+    std::iota(order_.begin(), order_.end(), Eigen::Index(0));
+    Eigen::MatrixXd inputs(states.rows(), static_cast<Eigen::Index>(config_.minibatch));
+    Eigen::MatrixXd labels(targets.rows(), static_cast<Eigen::Index>(config_.minibatch));
+    
+    double epoch_loss = 0.0;
+    for (int epoch = 0; epoch < config_.epochs; ++epoch) {
+        for (Eigen::Index i = n - 1; i > 0; --i) {
+            std::swap(order_[i], order_[rng_.below(static_cast<uint32_t>(i + 1))]);
+        }
+        
+        epoch_loss = 0.0;
+        for (Eigen::Index begin = 0; begin < n; begin += config_.minibatch) {
+            Eigen::Index count = std::min<Eigen::Index>(config_.minibatch, n - begin);
+            for (Eigen::Index j = 0; j < count; ++j) {
+                inputs.col(j) = states.col(order_[begin + j]);
+                labels.col(j) = targets.col(order_[begin + j]);
+            }
+            epoch_loss += student_.fitQValues(inputs.leftCols(count), labels.leftCols(count));
+            ++report.updates;
+        }
+    }
+    
+    report.states += static_cast<size_t>(n);
+    report.mean_loss = epoch_loss / static_cast<double>(n);
+    return report.mean_loss;
+}
+
+DistillationTrainer::Report DistillationTrainer::distillFromSimulator(VectorizedMusicEnvironment& env,
+                                                                      size_t num_states) {
+    Report report;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> actions(env.size());
+    
+    while (report.states < num_states) {
+        Eigen::MatrixXd obs = env.observations();
+        Eigen::MatrixXd q = teacher_.forwardBatch(obs, config_.num_threads);
+        fitStudent(obs, q, report);
+        
+        // Follow the teacher so the student sees the states it will be served on
+        for (Eigen::Index i = 0; i < q.cols(); ++i) {
+            if (rng_.uniform() < config_.simulator_epsilon) {
+                actions[i] = static_cast<int>(rng_.below(static_cast<uint32_t>(q.rows())));
+            } else {
+                Eigen::Index best;
+                q.col(i).maxCoeff(&best);
+                actions[i] = static_cast<int>(best);
+            }
+        }
+        env.step(actions);
+    }
+    
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+DistillationTrainer::Report DistillationTrainer::distillFromReplay(ExperienceBuffer& buffer, size_t num_states,
+                                                                   size_t chunk_size) {
+    Report report;
+    auto start = std::chrono::steady_clock::now();
+    chunk_size = std::min(chunk_size, buffer.size());
+    if (chunk_size == 0) {
+        return report;
+    }
+    
+    while (report.states < num_states) {
+        std::vector<Experience> experiences = buffer.sample(chunk_size);
+        Eigen::MatrixXd states(NeuralNetwork::INPUT_SIZE, static_cast<Eigen::Index>(2 * experiences.size()));
+        for (size_t i = 0; i < experiences.size(); ++i) {
+            states.col(2 * i) = experiences[i].state;
+            states.col(2 * i + 1) = experiences[i].next_state;
+        }
+        distillBatch(states, report);
+    }
+    
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+DistillationTrainer::Fidelity DistillationTrainer::evaluate(const NeuralNetwork& teacher,
+                                                            const NeuralNetwork& student,
+                                                            const Eigen::MatrixXd& states,
+                                                            unsigned num_threads) {
+    Eigen::MatrixXd teacher_q = teacher.forwardBatch(states, num_threads);
+    Eigen::MatrixXd student_q = student.forwardBatch(states, num_threads);
+    
+    size_t agree = 0;
+    for (Eigen::Index i = 0; i < states.cols(); ++i) {
+        Eigen::Index teacher_action, student_action;
+        teacher_q.col(i).maxCoeff(&teacher_action);
+        student_q.col(i).maxCoeff(&student_action);
+        agree += teacher_action == student_action;
+    }
+    
+    double n = static_cast<double>(std::max<Eigen::Index>(states.cols(), 1));
+    return Fidelity{agree / n, (teacher_q - student_q).cwiseAbs().sum() / (n * teacher_q.rows())};
+}
+
+} // namespace MusicAI
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "neural_network.h"
+#include "experience_buffer.h"
+#include "fast_rng.h"
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+class VectorizedMusicEnvironment;
+
+// Trains a small student network to reproduce a teacher's Q-values. States
+// come from the simulator or a replay buffer; the teacher labels them in
+// large batched forwards and the student is fit with minibatch regression
+// on all actions (NeuralNetwork::fitQValues). The student keeps the
+// standard model format, so its saveWeights output loads anywhere a full
+// model does.
+class DistillationTrainer {
+public:
+    struct Config {
+        size_t minibatch = 64;           // States per student update
+        int epochs = 2;                  // Passes over each teacher-labelled chunk
+        unsigned num_threads = 0;        // Teacher forward threads (0 = all cores)
+        double simulator_epsilon = 0.2;  // Random actions while rolling the simulator
+        uint64_t seed = 42;
+    };
+    
+    struct Report {
+        size_t states = 0;
+        size_t updates = 0;
+        double seconds = 0.0;
+        double mean_loss = 0.0;  // Per-sample loss over the last chunk's final epoch
+    };
+    
+    struct Fidelity {
+        double agreement;  // Fraction of states where greedy actions match
+        double q_mae;      // Mean absolute Q-value error
+    };
+    
+private:
+    const NeuralNetwork& teacher_;
+    NeuralNetwork& student_;
+    Config config_;
+    FastRng rng_;
+    std::vector<Eigen::Index> order_;  // Shuffled column order
+    
+public:
+    DistillationTrainer(const NeuralNetwork& teacher, NeuralNetwork& student)
+        : DistillationTrainer(teacher, student, Config()) {}
+    DistillationTrainer(const NeuralNetwork& teacher, NeuralNetwork& student, const Config& config);
+    
+    // Labels one chunk of states (one per column) and fits the student on it.
+    // Returns the per-sample loss of the final epoch.
+    double distillBatch(const Eigen::MatrixXd& states, Report& report);
+    
+    // Rolls the simulator with the teacher's epsilon-greedy policy and
+    // distills on every visited state until num_states have been used
+    Report distillFromSimulator(VectorizedMusicEnvironment& env, size_t num_states);
+    
+    // Distills on states (and next states) sampled from a replay buffer in
+    // chunks of chunk_size experiences
+    Report distillFromReplay(ExperienceBuffer& buffer, size_t num_states, size_t chunk_size = 4096);
+    
+    static Fidelity evaluate(const NeuralNetwork& teacher, const NeuralNetwork& student,
+                             const Eigen::MatrixXd& states, unsigned num_threads = 0);
+    
+private:
+    double fitStudent(const Eigen::MatrixXd& states, const Eigen::MatrixXd& targets, Report& report);
+};
+
+} // namespace MusicAI
@@ -0,0 +1,42 @@
+#include "dqn_update.h"
+#include <cmath>
+
+namespace MusicAI {
+
+double doubleDQNUpdate(NeuralNetwork& online,
+                       const NeuralNetwork& target,
+                       const std::vector<Experience>& batch,
+                       double gamma) {
+    Eigen::Index n = static_cast<Eigen::Index>(batch.size());
+    if (n == 0) {
+        return 0.0;
+    }
+    
+    Eigen::MatrixXd states(NeuralNetwork::INPUT_SIZE, n);
+    Eigen::MatrixXd next_states(NeuralNetwork::INPUT_SIZE, n);
+    Eigen::VectorXd rewards(n), discounts(n);
+    std::vector<int> actions(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        const Experience& exp = batch[i];
+        states.col(i) = exp.state;
+        next_states.col(i) = exp.next_state;
+        actions[i] = exp.action;
+        rewards(i) = exp.reward;
+        // N-step transitions already hold sum_k gamma^k r; bootstrap with gamma^n
+        discounts(i) = exp.done ? 0.0 : (exp.steps == 1 ? gamma : std::pow(gamma, exp.steps));
+    }
+    
+    // Double DQN: use main network to select action, target network to evaluate
+    Eigen::MatrixXd next_q_main = online.forwardBatch(next_states);
+    std::vector<int> best_actions(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        Eigen::Index best_action;
+        next_q_main.col(i).maxCoeff(&best_action);
+        best_actions[i] = static_cast<int>(best_action);
+    }
+    Eigen::MatrixXd targets = target.bellmanTargets(next_states, best_actions, rewards, discounts);
+    
+    return online.trainBatch(states, actions, targets);
+}
+
+} // namespace MusicAI
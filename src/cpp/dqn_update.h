@@ -0,0 +1,18 @@
+#pragma once
+
+#include "neural_network.h"
+#include "experience_buffer.h"
+#include <vector>
+
+namespace MusicAI {
+
+// One Double-DQN minibatch update: the online network picks next actions,
+// the target network evaluates them through its output head, and the online
+// network takes a TD step. N-step transitions bootstrap with gamma^steps.
+// Returns the summed batch loss.
+double doubleDQNUpdate(NeuralNetwork& online,
+                       const NeuralNetwork& target,
+                       const std::vector<Experience>& batch,
+                       double gamma);
+
+} // namespace MusicAI
@@ -1,13 +1,21 @@
 #include "experience_buffer.h"
 #include <algorithm>
 #include <random>
-#include <numeric>
 
 namespace MusicAI {
 
 ExperienceBuffer::ExperienceBuffer(size_t max_size) 
-    : max_size_(max_size), rng_(std::random_device{}()) {
-    buffer_.reserve(max_size);
+    : ExperienceBuffer(max_size, std::random_device{}()) {
+}
+
+ExperienceBuffer::ExperienceBuffer(size_t max_size, uint64_t seed) 
+    : max_size_(max_size) {
+    this->seed(seed);
+}
+
+void ExperienceBuffer::seed(uint64_t seed) {
+    std::seed_seq seed_sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    rng_.seed(seed_sequence);
 }
 
 void ExperienceBuffer::add(const Experience& experience) {
@@ -27,15 +35,20 @@ std::vector<Experience> ExperienceBuffer::sample(size_t batch_size) {
     std::vector<Experience> samples;
     samples.reserve(batch_size);
     
-    // Create indices for sampling
-    std::vector<size_t> indices(buffer_.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    
-    // Randomly shuffle and take first batch_size elements
-    std::shuffle(indices.begin(), indices.end(), rng_);
+    // Draw distinct indices directly instead of shuffling the whole buffer;
+    // batches are small so the duplicate check is cheap
+    std::uniform_int_distribution<size_t> index_dist(0, buffer_.size() - 1);
+    std::vector<size_t> indices;
+    indices.reserve(batch_size);
+    while (indices.size() < batch_size) {
+        size_t index = index_dist(rng_);
+        if (std::find(indices.begin(), indices.end(), index) == indices.end()) {
+            indices.push_back(index);
+        }
+    }
     
-    for (size_t i = 0; i < batch_size; ++i) {
-        samples.push_back(buffer_[indices[i]]);
+    for (size_t index : indices) {
+        samples.push_back(buffer_[index]);
     }
     
     return samples;
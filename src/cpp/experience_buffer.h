@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <deque>
 #include <random>
@@ -13,10 +14,11 @@ struct Experience {
     double reward;
     Eigen::VectorXd next_state;
     bool done;
+    int steps;  // Rewards summed into `reward`; bootstrap is discounted by gamma^steps
     
     Experience(const Eigen::VectorXd& s, int a, double r, 
-              const Eigen::VectorXd& ns, bool d)
-        : state(s), action(a), reward(r), next_state(ns), done(d) {}
+              const Eigen::VectorXd& ns, bool d, int n = 1)
+        : state(s), action(a), reward(r), next_state(ns), done(d), steps(n) {}
 };
 
 class ExperienceBuffer {
@@ -26,7 +28,10 @@ private:
     std::mt19937 rng_;
     
 public:
+    // Sampling is seeded from std::random_device unless a seed is given
     explicit ExperienceBuffer(size_t max_size = 10000);
+    ExperienceBuffer(size_t max_size, uint64_t seed);
+    void seed(uint64_t seed);
     
     void add(const Experience& experience);
     std::vector<Experience> sample(size_t batch_size);
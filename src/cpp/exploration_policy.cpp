@@ -0,0 +1,103 @@
+#include "exploration_policy.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+ExplorationPolicy::ExplorationPolicy(const ExplorationConfig& config, int num_actions)
+    : config_(config),
+      action_counts_(Eigen::VectorXd::Zero(num_actions)),
+      total_count_(0.0) {
+    if (num_actions <= 0) {
+        throw std::invalid_argument("ExplorationPolicy needs at least one action");
+    }
+    if (config_.type == ExplorationType::BOLTZMANN && !(config_.temperature > 0.0)) {
+        throw std::invalid_argument("Boltzmann temperature must be positive");
+    }
+}
+
+void ExplorationPolicy::selectActions(const Eigen::MatrixXd& q_values, double epsilon,
+                                      FastRng& rng, std::vector<int>& actions) {
+    if (q_values.rows() != action_counts_.size()) {
+        throw std::invalid_argument("Q-value rows do not match number of actions");
+    }
+    actions.resize(q_values.cols());
+    
+    switch (config_.type) {
+        case ExplorationType::EPSILON_GREEDY:
+            epsilonGreedy(q_values, epsilon, rng, actions);
+            break;
+        case ExplorationType::BOLTZMANN:
+            boltzmann(q_values, rng, actions);
+            break;
+        case ExplorationType::UCB:
+            ucb(q_values, actions);
+            break;
+    }
+}
+
+int ExplorationPolicy::selectAction(const Eigen::VectorXd& q_values, double epsilon, FastRng& rng) {
+    std::vector<int> actions;
+    selectActions(q_values, epsilon, rng, actions);
+    return actions[0];
+}
+
+void ExplorationPolicy::resetCounts() {
+    action_counts_.setZero();
+    total_count_ = 0.0;
+}
+
+void ExplorationPolicy::epsilonGreedy(const Eigen::MatrixXd& q_values, double epsilon,
+                                      FastRng& rng, std::vector<int>& actions) const {
+    const uint32_t num_actions = static_cast<uint32_t>(q_values.rows());
+    for (Eigen::Index i = 0; i < q_values.cols(); ++i) {
+        if (rng.uniform() < epsilon) {
+            actions[i] = static_cast<int>(rng.below(num_actions));
+        } else {
+            Eigen::Index best;
+            q_values.col(i).maxCoeff(&best);
+            actions[i] = static_cast<int>(best);
+        }
+    }
+}
+
+void ExplorationPolicy::boltzmann(const Eigen::MatrixXd& q_values, FastRng& rng,
+                                  std::vector<int>& actions) {
+    // Shift each column by its max, then one vectorized exp over the whole batch
+    const Eigen::RowVectorXd column_max = q_values.colwise().maxCoeff();
+    scratch_ = ((q_values.rowwise() - column_max) / config_.temperature).array().exp().matrix();
+    const Eigen::RowVectorXd column_sum = scratch_.colwise().sum();
+    
+    const Eigen::Index num_actions = q_values.rows();
+    for (Eigen::Index i = 0; i < q_values.cols(); ++i) {
+        double threshold = rng.uniform() * column_sum(i);
+        Eigen::Index action = num_actions - 1;
+        for (Eigen::Index a = 0; a < num_actions - 1; ++a) {
+            threshold -= scratch_(a, i);
+            if (threshold < 0.0) {
+                action = a;
+                break;
+            }
+        }
+        actions[i] = static_cast<int>(action);
+    }
+}
+
+void ExplorationPolicy::ucb(const Eigen::MatrixXd& q_values, std::vector<int>& actions) {
+    // Bonus is shared by every column in the batch; counts advance afterwards
+    const double log_total = std::log(total_count_ + 1.0);
+    const Eigen::VectorXd bonus =
+        (config_.ucb_c * (log_total / (action_counts_.array() + 1.0)).sqrt()).matrix();
+    
+    for (Eigen::Index i = 0; i < q_values.cols(); ++i) {
+        Eigen::Index best;
+        (q_values.col(i) + bonus).maxCoeff(&best);
+        actions[i] = static_cast<int>(best);
+    }
+    for (int action : actions) {
+        action_counts_(action) += 1.0;
+    }
+    total_count_ += static_cast<double>(actions.size());
+}
+
+} // namespace MusicAI
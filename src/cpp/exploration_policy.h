@@ -0,0 +1,53 @@
+#pragma once
+
+#include "fast_rng.h"
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+enum class ExplorationType {
+    EPSILON_GREEDY = 0,  // Random action with probability epsilon, else argmax
+    BOLTZMANN = 1,       // Sample from softmax(Q / temperature)
+    UCB = 2              // argmax Q + c * sqrt(ln N / (n_a + 1)) over action counts
+};
+
+struct ExplorationConfig {
+    ExplorationType type = ExplorationType::EPSILON_GREEDY;
+    double temperature = 0.1;  // Boltzmann
+    double ucb_c = 0.5;        // UCB exploration bonus scale
+};
+
+// Action selection over whole batches of Q-vectors (one column per request)
+// in a single pass. The caller owns the RNG, so seeding it makes selection
+// reproducible.
+class ExplorationPolicy {
+private:
+    ExplorationConfig config_;
+    Eigen::VectorXd action_counts_;  // UCB selection counts
+    double total_count_;
+    Eigen::MatrixXd scratch_;        // Boltzmann probabilities
+    
+public:
+    ExplorationPolicy() : ExplorationPolicy(ExplorationConfig()) {}
+    explicit ExplorationPolicy(const ExplorationConfig& config, int num_actions = 5);
+    
+    // Fills `actions` with one choice per column of q_values. epsilon is the
+    // current schedule value and only used by epsilon-greedy.
+    void selectActions(const Eigen::MatrixXd& q_values, double epsilon,
+                       FastRng& rng, std::vector<int>& actions);
+    int selectAction(const Eigen::VectorXd& q_values, double epsilon, FastRng& rng);
+    
+    const ExplorationConfig& getConfig() const { return config_; }
+    const Eigen::VectorXd& getActionCounts() const { return action_counts_; }
+    void resetCounts();
+    
+private:
+    void epsilonGreedy(const Eigen::MatrixXd& q_values, double epsilon,
+                       FastRng& rng, std::vector<int>& actions) const;
+    void boltzmann(const Eigen::MatrixXd& q_values, FastRng& rng, std::vector<int>& actions);
+    void ucb(const Eigen::MatrixXd& q_values, std::vector<int>& actions);
+};
+
+} // namespace MusicAI
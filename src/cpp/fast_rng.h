@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace MusicAI {
+
+// xoshiro256++ (Blackman & Vigna): 32 bytes of state, a handful of
+// instructions per draw. Seeded once through splitmix64; distinct `stream`
+// values give independent sequences for per-thread generators. Satisfies
+// UniformRandomBitGenerator, so it also works with <random> distributions.
+class FastRng {
+public:
+    using result_type = uint64_t;
+    
+private:
+    uint64_t state_[4];
+    
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    
+public:
+    explicit FastRng(uint64_t seed = 0, uint64_t stream = 0) {
+        this->seed(seed, stream);
+    }
+    
+    void seed(uint64_t seed, uint64_t stream = 0) {
+        uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ull);
+        for (auto& word : state_) {
+            word = splitmix64(x);
+        }
+    }
+    
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    
+    result_type operator()() {
+        uint64_t result = rotl(state_[0] + state_[3], 23) + state_[0];
+        uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+    
+    // Uniform double in [0, 1) with 53 random bits
+    double uniform() {
+        return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+    }
+    
+    // Uniform integer in [0, n) (Lemire's multiply-shift, negligible bias for small n)
+    uint32_t below(uint32_t n) {
+        return static_cast<uint32_t>(((*this)() >> 32) * n >> 32);
+    }
+};
+
+} // namespace MusicAI
@@ -0,0 +1,78 @@
+#include "fixed_trunk.h"
+
+namespace MusicAI {
+
+namespace {
+
+template <int In, int... Hidden>
+struct FixedTrunk;
+
+template <int In, int Out, int... Rest>
+struct FixedTrunk<In, Out, Rest...> {
+    template <typename Input>
+    static Eigen::VectorXd run(const Eigen::MatrixXd* weights, const Eigen::VectorXd* biases, const Input& x) {
+        Eigen::Matrix<double, Out, 1> h =
+            (Eigen::Map<const Eigen::Matrix<double, Out, In>>(weights->data()) * x +
+             Eigen::Map<const Eigen::Matrix<double, Out, 1>>(biases->data())).cwiseMax(0.0);
+        return FixedTrunk<Out, Rest...>::run(weights + 1, biases + 1, h);
+    }
+};
+
+template <int In>
+struct FixedTrunk<In> {
+    template <typename Input>
+    static Eigen::VectorXd run(const Eigen::MatrixXd*, const Eigen::VectorXd*, const Input& x) {
+        return x;
+    }
+};
+
+template <int In, int... Hidden>
+Eigen::VectorXd fixedKernel(const Eigen::MatrixXd* weights, const Eigen::VectorXd* biases,
+                            const Eigen::VectorXd& input) {
+    return FixedTrunk<In, Hidden...>::run(weights, biases,
+                                          Eigen::Map<const Eigen::Matrix<double, In, 1>>(input.data()));
+}
+
+struct Registration {
+    std::vector<int> hidden_sizes;
+    FixedTrunkKernel kernel;
+};
+
+// Shipped default, the wider beta model, and the distilled students
+const std::vector<Registration>& registrations() {
+    static const std::vector<Registration> table = {
+        {{64, 32, 16}, &fixedKernel<8, 64, 32, 16>},
+        {{128, 64, 32}, &fixedKernel<8, 128, 64, 32>},
+        {{32, 16}, &fixedKernel<8, 32, 16>},
+        {{32}, &fixedKernel<8, 32>},
+        {{16}, &fixedKernel<8, 16>},
+    };
+    return table;
+}
+
+} // namespace
+
+FixedTrunkKernel findFixedTrunkKernel(int input_size, const std::vector<int>& hidden_sizes) {
+    if (input_size != 8) {
+        return nullptr;
+    }
+    for (const Registration& registration : registrations()) {
+        if (registration.hidden_sizes == hidden_sizes) {
+            return registration.kernel;
+        }
+    }
+    return nullptr;
+}
+
+const std::vector<std::vector<int>>& fixedTrunkTopologies() {
+    static const std::vector<std::vector<int>> topologies = []() {
+        std::vector<std::vector<int>> result;
+        for (const Registration& registration : registrations()) {
+            result.push_back(registration.hidden_sizes);
+        }
+        return result;
+    }();
+    return topologies;
+}
+
+} // namespace MusicAI
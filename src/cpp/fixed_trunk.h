@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+// Single-state ReLU trunk evaluated with compile-time layer sizes. Weights
+// stay in the network's dynamic matrices and are viewed through fixed-size
+// maps, so kernels never need re-syncing after training.
+using FixedTrunkKernel = Eigen::VectorXd (*)(const Eigen::MatrixXd* weights,
+                                             const Eigen::VectorXd* biases,
+                                             const Eigen::VectorXd& input);
+
+// Kernel pre-instantiated for this input size and hidden widths, or nullptr
+FixedTrunkKernel findFixedTrunkKernel(int input_size, const std::vector<int>& hidden_sizes);
+
+// Topologies (hidden widths, 8 inputs) that have a pre-instantiated kernel
+const std::vector<std::vector<int>>& fixedTrunkTopologies();
+
+} // namespace MusicAI
@@ -0,0 +1,113 @@
+#include "hashed_embedding.h"
+#include "fast_rng.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+inline uint64_t mixBits(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+struct GradientEntry {
+    size_t bucket;
+    Eigen::Index sample;
+    double weight;
+};
+
+} // namespace
+
+HashedEmbeddingTable::HashedEmbeddingTable(const Config& config)
+    : config_(config), salt_(mixBits(config.seed + 0x9E3779B97F4A7C15ull)),
+      state_slot_(config.buckets, -1) {
+    if (config_.buckets == 0 || config_.dim <= 0) {
+        throw std::invalid_argument("Embedding table needs buckets and a positive dimension");
+    }
+    
+    FastRng rng(config_.seed);
+    embeddings_.resize(config_.dim, static_cast<Eigen::Index>(config_.buckets));
+    for (Eigen::Index i = 0; i < embeddings_.size(); ++i) {
+        embeddings_(i) = (2.0 * rng.uniform() - 1.0) * config_.init_scale;
+    }
+}
+
+size_t HashedEmbeddingTable::bucket(uint64_t id) const {
+    return static_cast<size_t>(mixBits(id ^ salt_) % config_.buckets);
+}
+
+void HashedEmbeddingTable::pool(const std::vector<Bag>& bags, Eigen::Ref<Eigen::MatrixXd> pooled) const {
+    if (pooled.rows() != config_.dim || pooled.cols() != static_cast<Eigen::Index>(bags.size())) {
+        throw std::invalid_argument("Pooled embedding shape mismatch");
+    }
+    
+    pooled.setZero();
+    for (size_t j = 0; j < bags.size(); ++j) {
+        const Bag& bag = bags[j];
+        for (uint64_t id : bag) {
+            pooled.col(j) += embeddings_.col(bucket(id));
+        }
+        if (config_.pooling == Pooling::MEAN && bag.size() > 1) {
+            pooled.col(j) /= static_cast<double>(bag.size());
+        }
+    }
+}
+
+size_t HashedEmbeddingTable::update(const std::vector<Bag>& bags,
+                                    const Eigen::Ref<const Eigen::MatrixXd>& pooled_grad) {
+    if (pooled_grad.rows() != config_.dim || pooled_grad.cols() != static_cast<Eigen::Index>(bags.size())) {
+        throw std::invalid_argument("Embedding gradient shape mismatch");
+    }
+    
+    // Group (bucket, sample) pairs so each bucket is stepped once per batch
+    std::vector<GradientEntry> entries;
+    for (size_t j = 0; j < bags.size(); ++j) {
+        double weight = config_.pooling == Pooling::MEAN && !bags[j].empty()
+            ? 1.0 / static_cast<double>(bags[j].size()) : 1.0;
+        for (uint64_t id : bags[j]) {
+            entries.push_back({bucket(id), static_cast<Eigen::Index>(j), weight});
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const GradientEntry& a, const GradientEntry& b) {
+        return a.bucket < b.bucket;
+    });
+    
+    const Eigen::Index dim = config_.dim;
+    Eigen::VectorXd gradient(dim);
+    size_t updated = 0;
+    for (size_t begin = 0; begin < entries.size();) {
+        const size_t bucket_index = entries[begin].bucket;
+        gradient.setZero();
+        size_t end = begin;
+        for (; end < entries.size() && entries[end].bucket == bucket_index; ++end) {
+            gradient += entries[end].weight * pooled_grad.col(entries[end].sample);
+        }
+        begin = end;
+        
+        int32_t& slot = state_slot_[bucket_index];
+        if (slot < 0) {
+            slot = static_cast<int32_t>(steps_.size());
+            steps_.push_back(0);
+            moments_.resize(moments_.size() + 2 * dim, 0.0);
+        }
+        Eigen::Map<Eigen::VectorXd> first(moments_.data() + 2 * dim * slot, dim);
+        Eigen::Map<Eigen::VectorXd> second(moments_.data() + 2 * dim * slot + dim, dim);
+        const uint32_t step = ++steps_[slot];
+        
+        first = config_.beta1 * first + (1.0 - config_.beta1) * gradient;
+        second = config_.beta2 * second + (1.0 - config_.beta2) * gradient.cwiseAbs2();
+        const double first_correction = 1.0 - std::pow(config_.beta1, step);
+        const double second_correction = 1.0 - std::pow(config_.beta2, step);
+        embeddings_.col(bucket_index).array() -=
+            config_.learning_rate * (first.array() / first_correction) /
+            ((second.array() / second_correction).sqrt() + config_.epsilon);
+        ++updated;
+    }
+    return updated;
+}
+
+} // namespace MusicAI
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <vector>
+
+namespace MusicAI {
+
+// Embedding table for categorical IDs (users, tracks, artists) hashed into a
+// fixed number of buckets, so unseen IDs need no vocabulary. A bag of IDs
+// per sample is pooled into one vector (embedding bag). Updates are sparse:
+// only the buckets used by the minibatch change, with lazy Adam whose
+// moment state is allocated the first time a bucket is trained, so step
+// cost tracks the batch rather than the table size.
+class HashedEmbeddingTable {
+public:
+    enum class Pooling {
+        SUM,
+        MEAN
+    };
+    
+    struct Config {
+        size_t buckets = 1 << 16;
+        int dim = 8;
+        Pooling pooling = Pooling::MEAN;
+        double learning_rate = 0.01;  // Adam
+        double beta1 = 0.9;
+        double beta2 = 0.999;
+        double epsilon = 1e-8;
+        double init_scale = 0.05;     // Uniform initial values in [-scale, scale]
+        uint64_t seed = 42;           // Initialization and hash salt
+    };
+    
+    using Bag = std::vector<uint64_t>;
+    
+private:
+    Config config_;
+    uint64_t salt_;
+    Eigen::MatrixXd embeddings_;       // dim x buckets, one column per bucket
+    std::vector<int32_t> state_slot_;  // Bucket -> Adam state slot, -1 until first update
+    std::vector<double> moments_;      // Per slot: first then second moment (dim each)
+    std::vector<uint32_t> steps_;      // Per slot: updates so far, for bias correction
+    
+public:
+    HashedEmbeddingTable() : HashedEmbeddingTable(Config()) {}
+    explicit HashedEmbeddingTable(const Config& config);
+    
+    size_t bucket(uint64_t id) const;
+    int dim() const { return config_.dim; }
+    size_t buckets() const { return config_.buckets; }
+    size_t trainedBuckets() const { return steps_.size(); }
+    const Config& getConfig() const { return config_; }
+    Eigen::VectorXd lookup(uint64_t id) const { return embeddings_.col(bucket(id)); }
+    
+    // Pooled embeddings of each sample's bag (dim x bags.size()); empty bags pool to zero
+    void pool(const std::vector<Bag>& bags, Eigen::Ref<Eigen::MatrixXd> pooled) const;
+    
+    // One lazy-Adam step from dLoss/dpooled (dim x bags.size()), touching only
+    // the buckets in the bags. Returns the number of buckets updated.
+    size_t update(const std::vector<Bag>& bags, const Eigen::Ref<const Eigen::MatrixXd>& pooled_grad);
+};
+
+} // namespace MusicAI
@@ -0,0 +1,119 @@
+#include "implicit_als.h"
+#include "fast_rng.h"
+#include "neural_network.h"
+#include "parallel_for.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+// Rows per parallel range; a row solve is a few microseconds
+constexpr size_t SOLVE_CHUNK = 256;
+
+} // namespace
+
+ImplicitALS::ImplicitALS(const Config& config) : config_(config) {
+    if (config_.factors <= 0 || config_.iterations < 0) {
+        throw std::invalid_argument("ALS needs a positive factor count");
+    }
+    if (!(config_.regularization >= 0.0f) || !(config_.alpha >= 0.0f)) {
+        throw std::invalid_argument("ALS regularization and alpha must be non-negative");
+    }
+}
+
+void ImplicitALS::initialize(Eigen::Index users, Eigen::Index tracks) {
+    FastRng rng(config_.seed);
+    user_factors_ = Eigen::MatrixXf::Zero(config_.factors, users);
+    item_factors_.resize(config_.factors, tracks);
+    for (Eigen::Index i = 0; i < item_factors_.size(); ++i) {
+        item_factors_.data()[i] = config_.init_scale * static_cast<float>(rng.uniform() * 2.0 - 1.0);
+    }
+}
+
+void ImplicitALS::iterate(const PlayMatrix& plays, const PlayMatrix& by_track) {
+    if (plays.rows() != user_factors_.cols() || plays.cols() != item_factors_.cols() ||
+        by_track.rows() != plays.cols() || by_track.cols() != plays.rows()) {
+        throw std::invalid_argument("Play matrix shape does not match the factors");
+    }
+    solve(plays, item_factors_, user_factors_);
+    solve(by_track, user_factors_, item_factors_);
+}
+
+void ImplicitALS::solve(const PlayMatrix& interactions, const Eigen::MatrixXf& fixed, Eigen::MatrixXf& solved) const {
+    const int f = config_.factors;
+    // Shared by every row: Y Y^T over all columns plus regularization
+    Eigen::MatrixXf gram = Eigen::MatrixXf::Zero(f, f);
+    gram.selfadjointView<Eigen::Lower>().rankUpdate(fixed);
+    gram.diagonal().array() += config_.regularization;
+    
+    parallelFor(static_cast<size_t>(interactions.outerSize()), config_.num_threads, [&](size_t begin, size_t end) {
+        Eigen::MatrixXf system(f, f);
+        Eigen::MatrixXf observed;
+        Eigen::VectorXf rhs(f);
+        Eigen::LLT<Eigen::MatrixXf> llt(f);
+        for (size_t row = begin; row < end; ++row) {
+            const Eigen::Index r = static_cast<Eigen::Index>(row);
+            // Uncompressed input (built with insert()) reserves more slots than it stores
+            const Eigen::Index count = interactions.isCompressed()
+                ? interactions.outerIndexPtr()[r + 1] - interactions.outerIndexPtr()[r]
+                : interactions.innerNonZeroPtr()[r];
+            if (count == 0) {
+                solved.col(r).setZero();
+                continue;
+            }
+            
+            // A = YY^T + lambda I + sum (c - 1) y y^T, b = sum c y over observed entries
+            observed.resize(f, count);
+            rhs.setZero();
+            Eigen::Index k = 0;
+            for (PlayMatrix::InnerIterator it(interactions, r); it; ++it, ++k) {
+                const float confidence = 1.0f + config_.alpha * it.value();
+                const auto y = fixed.col(it.index());
+                observed.col(k) = std::sqrt(confidence - 1.0f) * y;
+                rhs += confidence * y;
+            }
+            system = gram;
+            system.selfadjointView<Eigen::Lower>().rankUpdate(observed);
+            llt.compute(system);
+            solved.col(r) = llt.solve(rhs);
+        }
+    }, SOLVE_CHUNK);
+}
+
+double ImplicitALS::loss(const PlayMatrix& plays) const {
+    // Every pair as unobserved (confidence 1, preference 0): sum_u x^T (YY^T) x
+    Eigen::MatrixXf gram = item_factors_ * item_factors_.transpose();
+    double total = (gram * user_factors_).cwiseProduct(user_factors_).cast<double>().sum();
+    
+    // Correct the observed entries to confidence c and preference 1
+    for (Eigen::Index u = 0; u < plays.outerSize(); ++u) {
+        for (PlayMatrix::InnerIterator it(plays, u); it; ++it) {
+            double confidence = 1.0 + config_.alpha * it.value();
+            double prediction = score(static_cast<uint32_t>(u), static_cast<uint32_t>(it.index()));
+            total += confidence * (1.0 - prediction) * (1.0 - prediction) - prediction * prediction;
+        }
+    }
+    return total + config_.regularization *
+        (static_cast<double>(user_factors_.squaredNorm()) + static_cast<double>(item_factors_.squaredNorm()));
+}
+
+Eigen::MatrixXd ImplicitALS::appendUserFeatures(const Eigen::MatrixXd& states,
+                                                const std::vector<uint32_t>& users) const {
+    if (states.rows() != NeuralNetwork::INPUT_SIZE || static_cast<size_t>(states.cols()) != users.size()) {
+        throw std::invalid_argument("Need one 8-feature state per user");
+    }
+    Eigen::MatrixXd inputs(NeuralNetwork::INPUT_SIZE + config_.factors, states.cols());
+    inputs.topRows(NeuralNetwork::INPUT_SIZE) = states;
+    for (Eigen::Index j = 0; j < states.cols(); ++j) {
+        if (users[j] < user_factors_.cols()) {
+            inputs.col(j).tail(config_.factors) = user_factors_.col(users[j]).cast<double>();
+        } else {
+            inputs.col(j).tail(config_.factors).setZero();
+        }
+    }
+    return inputs;
+}
+
+} // namespace MusicAI
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <Eigen/SparseCore>
+#include <cstdint>
+#include <vector>
+
+namespace MusicAI {
+
+// Weighted alternating least squares for implicit feedback (Hu, Koren &
+// Volinsky): a play count r becomes preference 1 with confidence
+// 1 + alpha * r, and unobserved pairs are preference 0 with confidence 1.
+// Each half-iteration solves one small normal-equation system per user (or
+// track) with LLT. The dense part Y Y^T + lambda I is computed once per
+// half-iteration and shared, so a row only adds the rank-k correction of
+// its own k observed entries. Rows are solved in parallel. Factors are stored
+// one entity per column, like network batches, so a user's factors can be
+// appended to the session features as extra network inputs.
+class ImplicitALS {
+public:
+    using PlayMatrix = Eigen::SparseMatrix<float, Eigen::RowMajor>;  // users x tracks
+    
+    struct Config {
+        int factors = 16;
+        float regularization = 0.1f;
+        float alpha = 40.0f;         // Confidence per play
+        int iterations = 10;
+        float init_scale = 0.01f;
+        unsigned num_threads = 0;    // 0 = all cores
+        uint64_t seed = 42;
+    };
+    
+private:
+    Config config_;
+    Eigen::MatrixXf user_factors_;   // factors x users
+    Eigen::MatrixXf item_factors_;   // factors x tracks
+    
+public:
+    ImplicitALS() : ImplicitALS(Config()) {}
+    explicit ImplicitALS(const Config& config);
+    
+    // Runs config.iterations alternating sweeps from a random start. The
+    // optional callback receives the iteration number after each sweep.
+    template <typename Callback>
+    void fit(const PlayMatrix& plays, Callback&& after_iteration);
+    void fit(const PlayMatrix& plays) { fit(plays, [](int) {}); }
+    
+    // One users-then-tracks sweep; by_track is plays transposed (row-major)
+    void iterate(const PlayMatrix& plays, const PlayMatrix& by_track);
+    
+    // Weighted squared error plus regularization, in O(nnz * f + (U + T) * f^2)
+    double loss(const PlayMatrix& plays) const;
+    
+    const Eigen::MatrixXf& getUserFactors() const { return user_factors_; }
+    const Eigen::MatrixXf& getItemFactors() const { return item_factors_; }
+    int numFactors() const { return config_.factors; }
+    const Config& getConfig() const { return config_; }
+    
+    // Predicted preference of user for track
+    float score(uint32_t user, uint32_t track) const {
+        return user_factors_.col(user).dot(item_factors_.col(track));
+    }
+    
+    // Session states (8 x n) with each column's user factors appended, the
+    // input layout of a network built with input_size 8 + factors. Users
+    // outside the fitted range get zero factors.
+    Eigen::MatrixXd appendUserFeatures(const Eigen::MatrixXd& states, const std::vector<uint32_t>& users) const;
+    
+private:
+    void initialize(Eigen::Index users, Eigen::Index tracks);
+    // Solves every row of interactions against the fixed factors
+    void solve(const PlayMatrix& interactions, const Eigen::MatrixXf& fixed, Eigen::MatrixXf& solved) const;
+};
+
+template <typename Callback>
+void ImplicitALS::fit(const PlayMatrix& plays, Callback&& after_iteration) {
+    initialize(plays.rows(), plays.cols());
+    PlayMatrix by_track = plays.transpose();
+    for (int iteration = 0; iteration < config_.iterations; ++iteration) {
+        iterate(plays, by_track);
+        after_iteration(iteration);
+    }
+}
+
+} // namespace MusicAI
@@ -0,0 +1,131 @@
+#include "item_similarity.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+// Rows per block; blocks are dealt to workers round robin
+constexpr size_t ROW_CHUNK = 64;
+
+bool moreSimilar(const ItemSimilarity::Neighbor& a, const ItemSimilarity::Neighbor& b) {
+    return a.similarity > b.similarity || (a.similarity == b.similarity && a.track < b.track);
+}
+
+} // namespace
+
+ItemSimilarity ItemSimilarity::compute(const SessionMatrix& sessions, const Config& config) {
+    if (config.top_k <= 0) {
+        throw std::invalid_argument("top_k must be positive");
+    }
+    ItemSimilarity result(config);
+    const Eigen::Index num_tracks = sessions.cols();
+    const bool jaccard = config.measure == Measure::JACCARD;
+    const size_t k = static_cast<size_t>(config.top_k);
+    
+    // Row i of by_track lists the sessions containing track i
+    SessionMatrix by_track = sessions.transpose();
+    std::vector<float> norms(num_tracks);
+    std::vector<int> counts(num_tracks);
+    for (Eigen::Index i = 0; i < num_tracks; ++i) {
+        counts[i] = by_track.outerIndexPtr()[i + 1] - by_track.outerIndexPtr()[i];
+        float squared = 0.0f;
+        for (SessionMatrix::InnerIterator it(by_track, i); it; ++it) {
+            squared += it.value() * it.value();
+        }
+        norms[i] = std::sqrt(squared);
+    }
+    
+    // Fixed k slots per track, compacted after the parallel pass
+    std::vector<Neighbor> slots(static_cast<size_t>(num_tracks) * k);
+    std::vector<uint32_t> found(num_tracks);
+    // Popular tracks cost the most and tend to sit together in the ID space,
+    // so each worker takes every workers-th block rather than one long range
+    const size_t num_chunks = (static_cast<size_t>(num_tracks) + ROW_CHUNK - 1) / ROW_CHUNK;
+    const size_t workers = std::min<size_t>(resolveThreadCount(config.num_threads), num_chunks);
+    parallelFor(workers, static_cast<unsigned>(workers), [&](size_t worker_begin, size_t worker_end) {
+        std::vector<float> products(num_tracks, 0.0f);
+        std::vector<int> shared(num_tracks, 0);
+        std::vector<uint32_t> touched;
+        std::vector<Neighbor> heap;
+        for (size_t worker = worker_begin; worker < worker_end; ++worker) {
+            for (size_t chunk = worker; chunk < num_chunks; chunk += workers) {
+                const size_t chunk_end = std::min(static_cast<size_t>(num_tracks), (chunk + 1) * ROW_CHUNK);
+                for (size_t row = chunk * ROW_CHUNK; row < chunk_end; ++row) {
+                    const Eigen::Index i = static_cast<Eigen::Index>(row);
+                    touched.clear();
+                    for (SessionMatrix::InnerIterator session(by_track, i); session; ++session) {
+                        const float weight = session.value();
+                        for (SessionMatrix::InnerIterator it(sessions, session.index()); it; ++it) {
+                            const Eigen::Index j = it.index();
+                            if (shared[j]++ == 0) {
+                                touched.push_back(static_cast<uint32_t>(j));
+                            }
+                            products[j] += weight * it.value();
+                        }
+                    }
+                    
+                    heap.clear();
+                    for (uint32_t j : touched) {
+                        // Tracks whose play weights are all zero have no cosine
+                        bool scorable = jaccard || (norms[i] > 0.0f && norms[j] > 0.0f);
+                        if (j != static_cast<uint32_t>(i) && shared[j] >= config.min_cooccurrence && scorable) {
+                            float similarity = jaccard
+                                ? static_cast<float>(shared[j]) /
+                                      static_cast<float>(counts[i] + counts[j] - shared[j])
+                                : products[j] / (norms[i] * norms[j]);
+                            Neighbor neighbor{j, similarity};
+                            // Min-heap on similarity holding the k best so far
+                            if (heap.size() < k) {
+                                heap.push_back(neighbor);
+                                std::push_heap(heap.begin(), heap.end(), moreSimilar);
+                            } else if (moreSimilar(neighbor, heap.front())) {
+                                std::pop_heap(heap.begin(), heap.end(), moreSimilar);
+                                heap.back() = neighbor;
+                                std::push_heap(heap.begin(), heap.end(), moreSimilar);
+                            }
+                        }
+                        products[j] = 0.0f;
+                        shared[j] = 0;
+                    }
+                    std::sort_heap(heap.begin(), heap.end(), moreSimilar);
+                    std::copy(heap.begin(), heap.end(), slots.begin() + row * k);
+                    found[row] = static_cast<uint32_t>(heap.size());
+                }
+            }
+        }
+    });
+    
+    result.offsets_.resize(num_tracks + 1);
+    result.offsets_[0] = 0;
+    for (Eigen::Index i = 0; i < num_tracks; ++i) {
+        result.offsets_[i + 1] = result.offsets_[i] + found[i];
+    }
+    result.neighbors_.resize(result.offsets_.back());
+    for (Eigen::Index i = 0; i < num_tracks; ++i) {
+        std::copy_n(slots.begin() + i * k, found[i], result.neighbors_.begin() + result.offsets_[i]);
+    }
+    return result;
+}
+
+Eigen::SparseMatrix<float, Eigen::RowMajor> ItemSimilarity::toSparseMatrix() const {
+    const Eigen::Index n = static_cast<Eigen::Index>(numTracks());
+    Eigen::SparseMatrix<float, Eigen::RowMajor> matrix(n, n);
+    Eigen::VectorXi sizes(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        sizes(i) = static_cast<int>(numNeighbors(static_cast<uint32_t>(i)));
+    }
+    matrix.reserve(sizes);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        for (uint32_t r = offsets_[i]; r < offsets_[i + 1]; ++r) {
+            matrix.insert(i, neighbors_[r].track) = neighbors_[r].similarity;
+        }
+    }
+    matrix.makeCompressed();
+    return matrix;
+}
+
+} // namespace MusicAI
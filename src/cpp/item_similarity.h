@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Eigen/SparseCore>
+#include <cstdint>
+#include <vector>
+
+namespace MusicAI {
+
+// Top-k item-item similarity from listening sessions ("more like this").
+// Row i of X^T X (X: sessions x tracks) is accumulated on its own from the
+// sessions containing track i into a per-thread dense accumulator, scored
+// as cosine or Jaccard, and reduced to its k best entries with a heap, so
+// the full co-occurrence product is never built. Rows are split across
+// threads; each writes only its own k result slots.
+class ItemSimilarity {
+public:
+    using SessionMatrix = Eigen::SparseMatrix<float, Eigen::RowMajor>;  // sessions x tracks
+    
+    enum class Measure {
+        COSINE,   // x_i . x_j / (|x_i| |x_j|) over play weights
+        JACCARD   // |S_i & S_j| / |S_i | S_j| over session sets
+    };
+    
+    struct Config {
+        Measure measure = Measure::COSINE;
+        int top_k = 20;
+        int min_cooccurrence = 1;    // Sessions two tracks must share
+        unsigned num_threads = 0;    // 0 = all cores
+    };
+    
+    struct Neighbor {
+        uint32_t track;
+        float similarity;
+    };
+    
+private:
+    Config config_;
+    std::vector<uint32_t> offsets_;     // Per track start in neighbors_, plus the end
+    std::vector<Neighbor> neighbors_;   // Most similar first within each track
+    
+    explicit ItemSimilarity(const Config& config) : config_(config) {}
+    
+public:
+    static ItemSimilarity compute(const SessionMatrix& sessions, const Config& config);
+    static ItemSimilarity compute(const SessionMatrix& sessions) { return compute(sessions, Config()); }
+    
+    size_t numTracks() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+    size_t numNeighbors(uint32_t track) const { return offsets_[track + 1] - offsets_[track]; }
+    // Up to top_k neighbors of track (never itself), most similar first
+    const Neighbor* neighbors(uint32_t track) const { return neighbors_.data() + offsets_[track]; }
+    const Config& getConfig() const { return config_; }
+    
+    // Pruned similarity as a sparse tracks x tracks matrix
+    Eigen::SparseMatrix<float, Eigen::RowMajor> toSparseMatrix() const;
+};
+
+} // namespace MusicAI
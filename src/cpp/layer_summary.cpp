@@ -0,0 +1,31 @@
+#include "layer_summary.h"
+
+namespace MusicAI {
+
+void summarizeLayers(const std::vector<Eigen::VectorXd>& layers, std::vector<LayerSummary>& summaries) {
+    summaries.resize(layers.size());
+    
+    for (size_t i = 0; i < layers.size(); ++i) {
+        const auto values = layers[i].array();
+        LayerSummary& summary = summaries[i];
+        summary.layer = static_cast<int32_t>(i);
+        summary.neuron_count = static_cast<int32_t>(values.size());
+        
+        if (values.size() == 0) {
+            summary.active_count = summary.low_count = summary.medium_count = summary.high_count = 0;
+            summary.max_activation = summary.mean_activation = 0.0;
+            continue;
+        }
+        
+        // Each reduction is a packed compare/sum over the layer
+        int32_t below_medium = static_cast<int32_t>((values < LayerSummary::MEDIUM_UPPER).count());
+        summary.active_count = static_cast<int32_t>((values > LayerSummary::ACTIVE_THRESHOLD).count());
+        summary.low_count = static_cast<int32_t>((values < LayerSummary::LOW_UPPER).count());
+        summary.medium_count = below_medium - summary.low_count;
+        summary.high_count = summary.neuron_count - below_medium;
+        summary.max_activation = values.maxCoeff();
+        summary.mean_activation = values.mean();
+    }
+}
+
+} // namespace MusicAI
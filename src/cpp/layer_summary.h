@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+// Per-layer statistics the visualizer shows after each prediction. Plain
+// 8-byte-aligned layout so JS can read the array straight out of WASM memory:
+// six int32 counts followed by two float64 values (40 bytes per layer).
+struct LayerSummary {
+    int32_t layer;
+    int32_t neuron_count;
+    int32_t active_count;   // activation > ACTIVE_THRESHOLD
+    int32_t low_count;      // activation < LOW_UPPER
+    int32_t medium_count;   // LOW_UPPER <= activation < MEDIUM_UPPER
+    int32_t high_count;     // activation >= MEDIUM_UPPER
+    double max_activation;  // 0 for an empty layer
+    double mean_activation;
+    
+    static constexpr double ACTIVE_THRESHOLD = 0.1;
+    static constexpr double LOW_UPPER = 0.3;
+    static constexpr double MEDIUM_UPPER = 0.7;
+};
+
+static_assert(sizeof(LayerSummary) == 40, "LayerSummary layout is read directly by JS");
+
+// Summarizes every layer of one captured forward pass into `summaries`
+// (resized to layers.size()).
+void summarizeLayers(const std::vector<Eigen::VectorXd>& layers, std::vector<LayerSummary>& summaries);
+
+} // namespace MusicAI
@@ -0,0 +1,119 @@
+#include "linucb_policy.h"
+#include <stdexcept>
+
+namespace MusicAI {
+
+LinUCBPolicy::LinUCBPolicy(const Config& config) : config_(config) {
+    if (!(config_.regularization > 0.0) || !(config_.alpha >= 0.0)) {
+        throw std::invalid_argument("LinUCB needs positive regularization and non-negative alpha");
+    }
+    reset();
+}
+
+void LinUCBPolicy::reset() {
+    for (int arm = 0; arm < NUM_ARMS; ++arm) {
+        a_inverse_.middleCols<FEATURES>(arm * FEATURES).setIdentity();
+    }
+    a_inverse_ /= config_.regularization;
+    b_.setZero();
+    theta_.setZero();
+    pulls_.fill(0);
+}
+
+LinUCBPolicy::Features LinUCBPolicy::toFeatures(const double* state) {
+    Features features;
+    features.head<CONTEXT_SIZE>() = Eigen::Map<const Eigen::Matrix<double, CONTEXT_SIZE, 1>>(state);
+    features(CONTEXT_SIZE) = 1.0;
+    return features;
+}
+
+Eigen::MatrixXd LinUCBPolicy::scores(const Eigen::MatrixXd& states) const {
+    if (states.rows() != CONTEXT_SIZE) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    const Eigen::Index n = states.cols();
+    Eigen::Matrix<double, FEATURES, Eigen::Dynamic> features(FEATURES, n);
+    features.topRows<CONTEXT_SIZE>() = states;
+    features.row(CONTEXT_SIZE).setOnes();
+    
+    // Every arm's A_k^-1 x in one product (A_k^-1 is symmetric)
+    Eigen::Matrix<double, FEATURES * NUM_ARMS, Eigen::Dynamic> projected = a_inverse_.transpose() * features;
+    Eigen::MatrixXd result = theta_.transpose() * features;
+    for (int arm = 0; arm < NUM_ARMS; ++arm) {
+        auto variance = projected.middleRows<FEATURES>(arm * FEATURES).cwiseProduct(features).colwise().sum();
+        result.row(arm) += config_.alpha * variance.cwiseMax(0.0).cwiseSqrt();
+    }
+    return result;
+}
+
+void LinUCBPolicy::update(const Features& features, int arm, double reward) {
+    if (arm < 0 || arm >= NUM_ARMS) {
+        throw std::out_of_range("Action out of range");
+    }
+    // Sherman-Morrison: (A + x x^T)^-1 = A^-1 - (A^-1 x)(A^-1 x)^T / (1 + x^T A^-1 x)
+    auto inverse = a_inverse_.middleCols<FEATURES>(arm * FEATURES);
+    const Features projected = inverse * features;
+    inverse.noalias() -= (projected / (1.0 + features.dot(projected))) * projected.transpose();
+    b_.col(arm) += reward * features;
+    theta_.col(arm).noalias() = inverse * b_.col(arm);
+    ++pulls_[arm];
+}
+
+int LinUCBPolicy::predict(const std::vector<double>& state) {
+    if (state.size() != static_cast<size_t>(CONTEXT_SIZE)) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    Eigen::Index best;
+    scores(Eigen::Map<const Eigen::MatrixXd>(state.data(), CONTEXT_SIZE, 1)).col(0).maxCoeff(&best);
+    return static_cast<int>(best);
+}
+
+void LinUCBPolicy::train(const std::vector<double>& state,
+                         int action,
+                         double reward,
+                         const std::vector<double>& next_state,
+                         bool done) {
+    (void)next_state;
+    (void)done;
+    if (state.size() != static_cast<size_t>(CONTEXT_SIZE)) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    update(toFeatures(state.data()), action, reward);
+}
+
+std::vector<int> LinUCBPolicy::predictBatch(const Eigen::MatrixXd& states, unsigned num_threads) {
+    (void)num_threads;
+    Eigen::MatrixXd ucb = scores(states);
+    std::vector<int> actions(ucb.cols());
+    for (Eigen::Index j = 0; j < ucb.cols(); ++j) {
+        Eigen::Index best;
+        ucb.col(j).maxCoeff(&best);
+        actions[j] = static_cast<int>(best);
+    }
+    return actions;
+}
+
+void LinUCBPolicy::trainBatch(const Eigen::MatrixXd& states,
+                              const std::vector<int>& actions,
+                              const std::vector<double>& rewards,
+                              const Eigen::MatrixXd& next_states,
+                              const std::vector<bool>& dones) {
+    (void)next_states;
+    size_t n = static_cast<size_t>(states.cols());
+    if (states.rows() != CONTEXT_SIZE || actions.size() != n || rewards.size() != n || dones.size() != n) {
+        throw std::invalid_argument("Batch size mismatch");
+    }
+    for (size_t i = 0; i < n; ++i) {
+        update(toFeatures(states.col(i).data()), actions[i], rewards[i]);
+    }
+}
+
+std::vector<double> LinUCBPolicy::getQValues(const std::vector<double>& state) const {
+    if (state.size() != static_cast<size_t>(CONTEXT_SIZE)) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    Eigen::MatrixXd ucb = scores(Eigen::Map<const Eigen::MatrixXd>(state.data(), CONTEXT_SIZE, 1));
+    return std::vector<double>(ucb.data(), ucb.data() + ucb.size());
+}
+
+} // namespace MusicAI
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "neural_network.h"
+#include "recommendation_policy.h"
+#include <Eigen/Core>
+#include <array>
+#include <cstdint>
+
+namespace MusicAI {
+
+// Disjoint LinUCB (Li et al. 2010): one ridge regression per genre over the
+// session features plus a constant bias feature, choosing the arm with the
+// highest theta_k . x + alpha * sqrt(x^T A_k^-1 x). A_k^-1 is kept directly
+// and updated with Sherman-Morrison, so an update is O(d^2) with no
+// inversion. The inverses sit side by side in one fixed-size matrix, so
+// every arm's confidence width for a batch comes out of a single product.
+// Meant for cold users, where a full DQN has too little data to learn from.
+class LinUCBPolicy : public RecommendationPolicy {
+public:
+    static constexpr int CONTEXT_SIZE = NeuralNetwork::INPUT_SIZE;
+    static constexpr int FEATURES = CONTEXT_SIZE + 1;
+    static constexpr int NUM_ARMS = NeuralNetwork::OUTPUT_SIZE;
+    using Features = Eigen::Matrix<double, FEATURES, 1>;
+    
+    struct Config {
+        double alpha = 1.0;            // Confidence width multiplier
+        double regularization = 1.0;   // Ridge prior: A_k starts at lambda I
+    };
+    
+private:
+    Config config_;
+    Eigen::Matrix<double, FEATURES, FEATURES * NUM_ARMS> a_inverse_;  // [A_0^-1 ... A_K^-1]
+    Eigen::Matrix<double, FEATURES, NUM_ARMS> b_;                     // Reward-weighted feature sums
+    Eigen::Matrix<double, FEATURES, NUM_ARMS> theta_;                 // A_k^-1 b_k
+    std::array<uint64_t, NUM_ARMS> pulls_;
+    
+public:
+    LinUCBPolicy() : LinUCBPolicy(Config()) {}
+    explicit LinUCBPolicy(const Config& config);
+    
+    // RecommendationPolicy. Bandit updates ignore next_state and done, and
+    // batches are a single small product, so num_threads is unused.
+    int predict(const std::vector<double>& state) override;
+    void train(const std::vector<double>& state,
+               int action,
+               double reward,
+               const std::vector<double>& next_state,
+               bool done) override;
+    std::vector<int> predictBatch(const Eigen::MatrixXd& states, unsigned num_threads = 1) override;
+    void trainBatch(const Eigen::MatrixXd& states,
+                    const std::vector<int>& actions,
+                    const std::vector<double>& rewards,
+                    const Eigen::MatrixXd& next_states,
+                    const std::vector<bool>& dones) override;
+    // Upper confidence bounds
+    std::vector<double> getQValues(const std::vector<double>& state) const override;
+    
+    // Upper confidence bounds (NUM_ARMS x n) for states (one per column)
+    Eigen::MatrixXd scores(const Eigen::MatrixXd& states) const;
+    void update(const Features& features, int arm, double reward);
+    void reset();
+    
+    static Features toFeatures(const double* state);
+    const Eigen::Matrix<double, FEATURES, NUM_ARMS>& getTheta() const { return theta_; }
+    uint64_t getPulls(int arm) const { return pulls_[arm]; }
+    const Config& getConfig() const { return config_; }
+};
+
+} // namespace MusicAI
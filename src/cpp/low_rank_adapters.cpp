@@ -0,0 +1,291 @@
+#include "low_rank_adapters.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+constexpr uint32_t ADAPTER_MAGIC = 0x414C514D;  // "MQLA"
+constexpr uint32_t ADAPTER_VERSION = 1;
+
+using ConstMap = Eigen::Map<const Eigen::MatrixXd>;
+using MutableMap = Eigen::Map<Eigen::MatrixXd>;
+
+void activationGradient(Eigen::MatrixXd& delta, const Eigen::MatrixXd& outputs,
+                        NeuralNetwork::Activation activation) {
+    switch (activation) {
+        case NeuralNetwork::Activation::RELU:
+            delta.array() *= (outputs.array() > 0.0).cast<double>();
+            break;
+        case NeuralNetwork::Activation::TANH:
+            delta.array() *= 1.0 - outputs.array().square();
+            break;
+        case NeuralNetwork::Activation::LINEAR:
+            break;
+    }
+}
+
+} // namespace
+
+LowRankAdapters::LowRankAdapters(std::shared_ptr<const NeuralNetwork> base, const Config& config)
+    : base_(std::move(base)), config_(config), params_per_user_(0), rng_(config.seed) {
+    if (!base_) {
+        throw std::invalid_argument("Adapters need a base network");
+    }
+    NeuralNetwork::Architecture architecture = base_->getArchitecture();
+    const int num_hidden = static_cast<int>(architecture.hidden_sizes.size());
+    if (config_.rank <= 0) {
+        throw std::invalid_argument("Adapter rank must be positive");
+    }
+    if (config_.layers.empty()) {
+        for (int i = 0; i < num_hidden; ++i) {
+            config_.layers.push_back(i);
+        }
+    }
+    std::sort(config_.layers.begin(), config_.layers.end());
+    config_.layers.erase(std::unique(config_.layers.begin(), config_.layers.end()), config_.layers.end());
+    
+    head_ = base_->getHead().clone();
+    activations_ = architecture.activations;
+    adapter_index_.assign(num_hidden, -1);
+    for (int layer : config_.layers) {
+        if (layer < 0 || layer >= num_hidden) {
+            throw std::out_of_range("Adapted layer index out of range");
+        }
+        const Eigen::MatrixXd& weight = base_->getLayerWeights(layer);
+        AdaptedLayer adapted;
+        adapted.layer = layer;
+        adapted.rows = static_cast<int>(weight.rows());
+        adapted.cols = static_cast<int>(weight.cols());
+        adapted.a_offset = params_per_user_;
+        adapted.b_offset = params_per_user_ + static_cast<size_t>(config_.rank) * adapted.cols;
+        params_per_user_ = adapted.b_offset + static_cast<size_t>(adapted.rows) * config_.rank;
+        adapter_index_[layer] = static_cast<int>(adapted_.size());
+        adapted_.push_back(adapted);
+    }
+}
+
+uint32_t LowRankAdapters::addUser(uint64_t user_id) {
+    auto found = slots_.find(user_id);
+    if (found != slots_.end()) {
+        return found->second;
+    }
+    
+    uint32_t slot = static_cast<uint32_t>(slots_.size());
+    arena_.resize(arena_.size() + params_per_user_, 0.0);
+    double* params = arena_.data() + static_cast<size_t>(slot) * params_per_user_;
+    for (const AdaptedLayer& adapted : adapted_) {
+        // Uniform A scaled like the base layer's fan-in; B stays zero
+        double limit = 1.0 / std::sqrt(static_cast<double>(adapted.cols));
+        for (size_t i = 0; i < static_cast<size_t>(config_.rank) * adapted.cols; ++i) {
+            params[adapted.a_offset + i] = (2.0 * rng_.uniform() - 1.0) * limit;
+        }
+    }
+    slots_.emplace(user_id, slot);
+    return slot;
+}
+
+void LowRankAdapters::forwardTrunk(const double* adapter, const Eigen::MatrixXd& inputs,
+                                   std::vector<Eigen::MatrixXd>& layer_outputs) const {
+    layer_outputs.resize(adapter_index_.size() + 1);
+    layer_outputs[0] = inputs;
+    for (size_t i = 0; i < adapter_index_.size(); ++i) {
+        const int layer = static_cast<int>(i);
+        Eigen::MatrixXd& z = layer_outputs[i + 1];
+        z.noalias() = base_->getLayerWeights(layer) * layer_outputs[i];
+        z.colwise() += base_->getLayerBias(layer);
+        if (adapter && adapter_index_[i] >= 0) {
+            const AdaptedLayer& adapted = adapted_[adapter_index_[i]];
+            ConstMap a(adapter + adapted.a_offset, config_.rank, adapted.cols);
+            ConstMap b(adapter + adapted.b_offset, adapted.rows, config_.rank);
+            z.noalias() += b * (a * layer_outputs[i]);
+        }
+        NeuralNetwork::applyActivation(z, activations_[i]);
+    }
+}
+
+void LowRankAdapters::evaluate(const std::vector<uint64_t>& users, const Eigen::MatrixXd& states,
+                               Eigen::MatrixXd& q_values) const {
+    if (states.rows() != base_->getInputSize() || static_cast<size_t>(states.cols()) != users.size()) {
+        throw std::invalid_argument("Need one state column per user");
+    }
+    
+    std::vector<const double*> adapters(users.size(), nullptr);
+    for (size_t j = 0; j < users.size(); ++j) {
+        auto found = slots_.find(users[j]);
+        if (found != slots_.end()) {
+            adapters[j] = arena_.data() + static_cast<size_t>(found->second) * params_per_user_;
+        }
+    }
+    
+    // Shared base GEMM per layer, then each column's own rank-r correction
+    Eigen::MatrixXd current = states;
+    Eigen::VectorXd low_rank(config_.rank);
+    for (size_t i = 0; i < adapter_index_.size(); ++i) {
+        const int layer = static_cast<int>(i);
+        Eigen::MatrixXd next = base_->getLayerWeights(layer) * current;
+        next.colwise() += base_->getLayerBias(layer);
+        if (adapter_index_[i] >= 0) {
+            const AdaptedLayer& adapted = adapted_[adapter_index_[i]];
+            for (size_t j = 0; j < users.size(); ++j) {
+                if (!adapters[j]) {
+                    continue;
+                }
+                const Eigen::Index col = static_cast<Eigen::Index>(j);
+                low_rank.noalias() = ConstMap(adapters[j] + adapted.a_offset, config_.rank, adapted.cols) *
+                                     current.col(col);
+                next.col(col).noalias() +=
+                    ConstMap(adapters[j] + adapted.b_offset, adapted.rows, config_.rank) * low_rank;
+            }
+        }
+        NeuralNetwork::applyActivation(next, activations_[i]);
+        current = std::move(next);
+    }
+    q_values = base_->getHead().forward(current);
+}
+
+Eigen::VectorXd LowRankAdapters::forward(uint64_t user_id, const Eigen::VectorXd& state) const {
+    Eigen::MatrixXd q_values;
+    evaluate({user_id}, state, q_values);
+    return q_values.col(0);
+}
+
+double LowRankAdapters::train(uint64_t user_id, const std::vector<Experience>& batch, double gamma) {
+    Eigen::Index n = static_cast<Eigen::Index>(batch.size());
+    if (n == 0) {
+        return 0.0;
+    }
+    double* adapter = arena_.data() + static_cast<size_t>(addUser(user_id)) * params_per_user_;
+    
+    Eigen::MatrixXd states(base_->getInputSize(), n);
+    Eigen::MatrixXd next_states(base_->getInputSize(), n);
+    Eigen::VectorXd rewards(n), discounts(n);
+    std::vector<int> actions(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        const Experience& exp = batch[i];
+        states.col(i) = exp.state;
+        next_states.col(i) = exp.next_state;
+        actions[i] = exp.action;
+        rewards(i) = exp.reward;
+        discounts(i) = exp.done ? 0.0 : (exp.steps == 1 ? gamma : std::pow(gamma, exp.steps));
+    }
+    
+    std::vector<Eigen::MatrixXd> layer_outputs;
+    forwardTrunk(adapter, next_states, layer_outputs);
+    Eigen::MatrixXd next_q = base_->getHead().forward(layer_outputs.back());
+    std::vector<int> best_actions(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        Eigen::Index best_action;
+        next_q.col(i).maxCoeff(&best_action);
+        best_actions[i] = static_cast<int>(best_action);
+    }
+    Eigen::MatrixXd targets = base_->bellmanTargets(next_states, best_actions, rewards, discounts);
+    
+    // Learning rate 0: the head only reports dLoss/dfeatures
+    forwardTrunk(adapter, states, layer_outputs);
+    double loss = 0.0;
+    Eigen::MatrixXd delta = head_->backwardTD(layer_outputs.back(), actions, targets, 0.0, loss);
+    
+    const double lr = config_.learning_rate;
+    for (int i = static_cast<int>(adapter_index_.size()) - 1; i >= 0; --i) {
+        if (i < config_.layers.front()) {
+            break;  // Nothing at or below this layer is trained
+        }
+        activationGradient(delta, layer_outputs[i + 1], activations_[i]);
+        
+        Eigen::MatrixXd prev_delta;
+        if (i > 0) {
+            prev_delta = base_->getLayerWeights(i).transpose() * delta;
+        }
+        if (adapter_index_[i] >= 0) {
+            const AdaptedLayer& adapted = adapted_[adapter_index_[i]];
+            MutableMap a(adapter + adapted.a_offset, config_.rank, adapted.cols);
+            MutableMap b(adapter + adapted.b_offset, adapted.rows, config_.rank);
+            Eigen::MatrixXd b_delta = b.transpose() * delta;  // rank x n
+            if (i > 0) {
+                prev_delta.noalias() += a.transpose() * b_delta;
+            }
+            Eigen::MatrixXd low_rank = a * layer_outputs[i];
+            b.noalias() -= lr * (delta * low_rank.transpose());
+            a.noalias() -= lr * (b_delta * layer_outputs[i].transpose());
+        }
+        delta = std::move(prev_delta);
+    }
+    return loss;
+}
+
+void LowRankAdapters::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filename);
+    }
+    
+    int32_t rank = config_.rank;
+    uint32_t num_adapted = static_cast<uint32_t>(adapted_.size());
+    uint64_t num_users = slots_.size();
+    file.write(reinterpret_cast<const char*>(&ADAPTER_MAGIC), sizeof(ADAPTER_MAGIC));
+    file.write(reinterpret_cast<const char*>(&ADAPTER_VERSION), sizeof(ADAPTER_VERSION));
+    file.write(reinterpret_cast<const char*>(&rank), sizeof(rank));
+    file.write(reinterpret_cast<const char*>(&num_adapted), sizeof(num_adapted));
+    for (const AdaptedLayer& adapted : adapted_) {
+        int32_t shape[3] = {adapted.layer, adapted.rows, adapted.cols};
+        file.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+    }
+    file.write(reinterpret_cast<const char*>(&num_users), sizeof(num_users));
+    for (const auto& entry : slots_) {
+        file.write(reinterpret_cast<const char*>(&entry.first), sizeof(entry.first));
+        file.write(reinterpret_cast<const char*>(arena_.data() + static_cast<size_t>(entry.second) * params_per_user_),
+                   params_per_user_ * sizeof(double));
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write adapters: " + filename);
+    }
+}
+
+void LowRankAdapters::load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for reading: " + filename);
+    }
+    
+    uint32_t magic = 0, version = 0, num_adapted = 0;
+    int32_t rank = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&rank), sizeof(rank));
+    file.read(reinterpret_cast<char*>(&num_adapted), sizeof(num_adapted));
+    bool compatible = file && magic == ADAPTER_MAGIC && version == ADAPTER_VERSION &&
+                      rank == config_.rank && num_adapted == adapted_.size();
+    for (size_t i = 0; compatible && i < adapted_.size(); ++i) {
+        int32_t shape[3];
+        file.read(reinterpret_cast<char*>(shape), sizeof(shape));
+        compatible = file && shape[0] == adapted_[i].layer && shape[1] == adapted_[i].rows &&
+                     shape[2] == adapted_[i].cols;
+    }
+    if (!compatible) {
+        throw std::runtime_error("Adapters do not match this base network: " + filename);
+    }
+    
+    uint64_t num_users = 0;
+    file.read(reinterpret_cast<char*>(&num_users), sizeof(num_users));
+    std::vector<double> arena;
+    std::unordered_map<uint64_t, uint32_t> slots;
+    for (uint64_t i = 0; i < num_users && file; ++i) {
+        uint64_t user_id = 0;
+        file.read(reinterpret_cast<char*>(&user_id), sizeof(user_id));
+        arena.resize(arena.size() + params_per_user_);
+        file.read(reinterpret_cast<char*>(arena.data() + arena.size() - params_per_user_),
+                  params_per_user_ * sizeof(double));
+        slots.emplace(user_id, static_cast<uint32_t>(i));
+    }
+    if (!file || slots.size() != num_users) {
+        throw std::runtime_error("Truncated adapter file: " + filename);
+    }
+    arena_ = std::move(arena);
+    slots_ = std::move(slots);
+}
+
+} // namespace MusicAI
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "neural_network.h"
+#include "experience_buffer.h"
+#include "fast_rng.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MusicAI {
+
+// Per-user low-rank corrections on a shared, frozen base network. An adapted
+// hidden layer computes act(W h + b + B_u A_u h), with A_u (rank x in) and
+// B_u (out x rank) owned by user u, so a user costs rank * (in + out)
+// doubles per adapted layer instead of a full network. Adapters live in one
+// arena indexed by user ID. B starts at zero, so a new user scores exactly
+// like the base network, and users without adapters are served by the base.
+class LowRankAdapters {
+public:
+    struct Config {
+        int rank = 4;
+        std::vector<int> layers;       // Hidden layers to adapt (empty = all)
+        double learning_rate = 0.001;
+        uint64_t seed = 42;            // A initialization
+    };
+    
+private:
+    struct AdaptedLayer {
+        int layer;
+        int rows;
+        int cols;
+        size_t a_offset;  // Within one user's parameters, column-major
+        size_t b_offset;
+    };
+    
+    std::shared_ptr<const NeuralNetwork> base_;
+    std::unique_ptr<OutputHead> head_;  // Base head copy for gradients; never stepped
+    Config config_;
+    std::vector<NeuralNetwork::Activation> activations_;
+    std::vector<int> adapter_index_;    // Per hidden layer: index into adapted_ or -1
+    std::vector<AdaptedLayer> adapted_;
+    size_t params_per_user_;
+    std::vector<double> arena_;
+    std::unordered_map<uint64_t, uint32_t> slots_;  // User ID -> arena slot
+    FastRng rng_;
+    
+public:
+    explicit LowRankAdapters(std::shared_ptr<const NeuralNetwork> base)
+        : LowRankAdapters(std::move(base), Config()) {}
+    LowRankAdapters(std::shared_ptr<const NeuralNetwork> base, const Config& config);
+    
+    // Creates the user's adapters if missing; returns the arena slot
+    uint32_t addUser(uint64_t user_id);
+    bool hasUser(uint64_t user_id) const { return slots_.count(user_id) != 0; }
+    size_t numUsers() const { return slots_.size(); }
+    size_t parametersPerUser() const { return params_per_user_; }
+    const Config& getConfig() const { return config_; }
+    const NeuralNetwork& getBase() const { return *base_; }
+    
+    // Q-values (numActions x batch) for states (one per column) of the given
+    // users: one shared GEMM per layer plus a rank-r correction per column
+    void evaluate(const std::vector<uint64_t>& users, const Eigen::MatrixXd& states,
+                  Eigen::MatrixXd& q_values) const;
+    Eigen::VectorXd forward(uint64_t user_id, const Eigen::VectorXd& state) const;
+    
+    // Double-DQN step on the user's adapters only: the adapted network picks
+    // next actions and the frozen base network evaluates them, as the target
+    // network does in doubleDQNUpdate. Adds the user if missing. Returns the
+    // summed batch loss.
+    double train(uint64_t user_id, const std::vector<Experience>& batch, double gamma);
+    
+    // Arena serialization; load requires the same rank and adapted layer shapes
+    void save(const std::string& filename) const;
+    void load(const std::string& filename);
+    
+private:
+    void forwardTrunk(const double* adapter, const Eigen::MatrixXd& inputs,
+                      std::vector<Eigen::MatrixXd>& layer_outputs) const;
+};
+
+} // namespace MusicAI
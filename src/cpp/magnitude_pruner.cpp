@@ -0,0 +1,47 @@
+#include "magnitude_pruner.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace MusicAI {
+
+MagnitudePruner::MagnitudePruner(const Config& config)
+    : config_(config), step_(0), applied_sparsity_(0.0) {
+    if (config_.final_sparsity < config_.initial_sparsity || config_.initial_sparsity < 0.0 ||
+        config_.final_sparsity >= 1.0) {
+        throw std::invalid_argument("Pruning sparsities must satisfy 0 <= initial <= final < 1");
+    }
+    if (config_.end_step <= config_.begin_step || config_.frequency < 1) {
+        throw std::invalid_argument("Pruning schedule needs end_step > begin_step and frequency >= 1");
+    }
+}
+
+double MagnitudePruner::sparsityAt(int step) const {
+    if (step < config_.begin_step) {
+        return 0.0;
+    }
+    double progress = std::min(1.0, static_cast<double>(step - config_.begin_step) /
+                                        (config_.end_step - config_.begin_step));
+    double remaining = 1.0 - progress;
+    return config_.final_sparsity +
+           (config_.initial_sparsity - config_.final_sparsity) * remaining * remaining * remaining;
+}
+
+bool MagnitudePruner::step(NeuralNetwork& network) {
+    int current = step_++;
+    // The last round lands on end_step even when the span is not a multiple
+    // of frequency, so final_sparsity is always reached
+    if (current < config_.begin_step || current > config_.end_step ||
+        ((current - config_.begin_step) % config_.frequency != 0 && current != config_.end_step)) {
+        return false;
+    }
+    
+    double sparsity = sparsityAt(current);
+    if (sparsity <= 0.0 && !network.isPruned()) {
+        return false;
+    }
+    network.pruneByMagnitude(sparsity);
+    applied_sparsity_ = sparsity;
+    return true;
+}
+
+} // namespace MusicAI
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "neural_network.h"
+
+namespace MusicAI {
+
+// Gradual magnitude pruning: target sparsity ramps from initial to final
+// over [begin_step, end_step] along a cubic curve (fast early, gentle near
+// the end) and the network is re-pruned every `frequency` training updates
+// and once more at end_step, so the remaining weights can recover between
+// rounds and the last round applies final_sparsity.
+class MagnitudePruner {
+public:
+    struct Config {
+        double initial_sparsity = 0.0;
+        double final_sparsity = 0.8;
+        int begin_step = 0;
+        int end_step = 20000;
+        int frequency = 500;
+    };
+    
+private:
+    Config config_;
+    int step_;
+    double applied_sparsity_;
+    
+public:
+    MagnitudePruner() : MagnitudePruner(Config()) {}
+    explicit MagnitudePruner(const Config& config);
+    
+    double sparsityAt(int step) const;
+    
+    // Call once per training update; returns true when it pruned
+    bool step(NeuralNetwork& network);
+    
+    int getStep() const { return step_; }
+    double getAppliedSparsity() const { return applied_sparsity_; }
+    const Config& getConfig() const { return config_; }
+};
+
+} // namespace MusicAI
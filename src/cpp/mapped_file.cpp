@@ -0,0 +1,56 @@
+#include "mapped_file.h"
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MUSICAI_HAVE_MMAP 1
+#endif
+
+namespace MusicAI {
+
+MappedFile MappedFile::open(const std::string& filename) {
+    MappedFile file;
+    
+#ifdef MUSICAI_HAVE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file for reading: " + filename);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + filename);
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* data = size > 0 ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file: " + filename);
+    }
+    file.data = std::shared_ptr<const void>(data, [size](const void* ptr) {
+        ::munmap(const_cast<void*>(ptr), size);
+    });
+    file.size = size;
+#else
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+    if (!stream.is_open()) {
+        throw std::runtime_error("Cannot open file for reading: " + filename);
+    }
+    file.size = static_cast<size_t>(stream.tellg());
+    stream.seekg(0);
+    // uint64_t storage keeps float and fp16 sections aligned
+    auto buffer = std::make_shared<std::vector<uint64_t>>((file.size + 7) / 8);
+    stream.read(reinterpret_cast<char*>(buffer->data()), file.size);
+    file.data = std::shared_ptr<const void>(buffer, buffer->data());
+#endif
+    
+    return file;
+}
+
+} // namespace MusicAI
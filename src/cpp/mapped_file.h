@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace MusicAI {
+
+// Read-only contents of a whole file, memory-mapped where the platform has
+// mmap and otherwise read into a buffer aligned for 8-byte values. The bytes
+// stay valid while any copy of `data` is alive, so structures that point
+// into the file hold on to it.
+struct MappedFile {
+    std::shared_ptr<const void> data;
+    size_t size = 0;
+    
+    // Throws std::runtime_error if the file cannot be opened or mapped
+    static MappedFile open(const std::string& filename);
+};
+
+} // namespace MusicAI
@@ -1,13 +1,129 @@
 #include "music_environment.h"
 #include <cmath>
 #include <random>
+#include <stdexcept>
+#include <algorithm>
 
 namespace MusicAI {
 
-MusicEnvironment::MusicEnvironment() : rng_(std::random_device{}()) {
+namespace {
+
+constexpr int NUM_ACTIONS = 5;
+
+// Weather-music compatibility, indexed [weather][action]. The last row is the
+// default used for out-of-range weather codes.
+constexpr double WEATHER_COMPATIBILITY[6][NUM_ACTIONS] = {
+    // CHILL  POP   ROCK  JAZZ  EDM
+    {0.3, 0.8, 0.6, 0.4, 0.7},  // SUNNY
+    {0.8, 0.5, 0.4, 0.7, 0.3},  // CLOUDY
+    {0.9, 0.3, 0.2, 0.8, 0.1},  // RAINY
+    {0.7, 0.4, 0.3, 0.8, 0.2},  // SNOWY
+    {0.5, 0.3, 0.8, 0.4, 0.6},  // STORMY
+    {0.5, 0.5, 0.5, 0.5, 0.5}   // Unknown
+};
+
+// Time-of-day compatibility, indexed [time bucket][action]
+constexpr double TIME_COMPATIBILITY[4][NUM_ACTIONS] = {
+    // CHILL  POP   ROCK  JAZZ  EDM
+    {0.8, 0.5, 0.2, 0.7, 0.1},  // Early morning (5-9)
+    {0.9, 0.4, 0.3, 0.6, 0.2},  // Work hours (9-17)
+    {0.4, 0.8, 0.7, 0.5, 0.6},  // Evening (17-22)
+    {0.9, 0.3, 0.1, 0.8, 0.1}   // Night (22-5)
+};
+
+// Recency weights for genre consistency (more recent history weighs more)
+constexpr double HISTORY_WEIGHTS[3] = {1.0 - 0 * 0.2, 1.0 - 1 * 0.2, 1.0 - 2 * 0.2};
+
+inline int weatherIndex(double weather_condition) {
+    int weather = static_cast<int>(weather_condition);
+    return (weather >= 0 && weather <= 4) ? weather : 5;
+}
+
+// Branch-free bucket selection; NaN hours fall through to night like the
+// original if/else chain
+inline int timeBucket(double hour) {
+    int morning = (hour >= 5) & (hour < 9);
+    int work = (hour >= 9) & (hour < 17);
+    int evening = (hour >= 17) & (hour < 22);
+    return 3 - 3 * morning - 2 * work - evening;
+}
+
+inline double genreConsistency(double action_value, double h0, double h1, double h2) {
+    double similarity = 0.0;
+    similarity += HISTORY_WEIGHTS[0] * (1.0 - std::abs(action_value - h0));
+    similarity += HISTORY_WEIGHTS[1] * (1.0 - std::abs(action_value - h1));
+    similarity += HISTORY_WEIGHTS[2] * (1.0 - std::abs(action_value - h2));
+    return similarity / 3.0;
+}
+
+// Combines the looked-up bonuses into the final reward. Shared by the scalar
+// and batched paths so both produce identical bits.
+inline double combineReward(int action, double temperature, double h0, double h1, double h2,
+                            double user_rating, double weather_bonus, double time_bonus) {
+    double base_reward = (user_rating - 2.5) / 2.5;
+    double consistency_bonus = genreConsistency(static_cast<double>(action) / 4.0, h0, h1, h2);
+    
+    // Hot weather + energetic music, or cold weather + calm music
+    int energetic = (action == 1) | (action == 4);
+    int calm = (action == 0) | (action == 3);
+    int temp_match = ((temperature > 0.5) & energetic) | ((temperature < -0.5) & calm);
+    double temp_bonus = temp_match ? 0.1 : 0.0;
+    
+    double total_reward = base_reward + 0.3 * weather_bonus + 0.2 * time_bonus +
+                         0.2 * consistency_bonus + temp_bonus;
+    return std::max(-1.0, std::min(1.0, total_reward));
+}
+
+} // namespace
+
+void MusicEnvironment::StateBatch::resize(size_t n) {
+    temperature.resize(n);
+    weather_condition.resize(n);
+    hour_of_day.resize(n);
+    day_of_week.resize(n);
+    user_mood.resize(n);
+    for (auto& history : genre_history) {
+        history.resize(n);
+    }
+}
+
+void MusicEnvironment::StateBatch::set(size_t i, const State& state) {
+    temperature[i] = state.temperature;
+    weather_condition[i] = state.weather_condition;
+    hour_of_day[i] = state.hour_of_day;
+    day_of_week[i] = state.day_of_week;
+    user_mood[i] = state.user_mood;
+    for (int h = 0; h < 3; ++h) {
+        genre_history[h][i] = state.genre_history[h];
+    }
+}
+
+MusicEnvironment::State MusicEnvironment::StateBatch::get(size_t i) const {
+    State state;
+    state.temperature = temperature[i];
+    state.weather_condition = weather_condition[i];
+    state.hour_of_day = hour_of_day[i];
+    state.day_of_week = day_of_week[i];
+    state.user_mood = user_mood[i];
+    for (int h = 0; h < 3; ++h) {
+        state.genre_history[h] = genre_history[h][i];
+    }
+    return state;
+}
+
+MusicEnvironment::MusicEnvironment() : MusicEnvironment(std::random_device{}()) {
+}
+
+MusicEnvironment::MusicEnvironment(uint64_t seed) {
+    this->seed(seed);
     reset();
 }
 
+void MusicEnvironment::seed(uint64_t seed) {
+    std::seed_seq seed_sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    rng_.seed(seed_sequence);
+}
+
 MusicEnvironment::State MusicEnvironment::reset() {
     // Initialize with random state for training diversity
     std::uniform_real_distribution<double> temp_dist(-1.0, 1.0);  // Normalized temperature
@@ -30,36 +146,74 @@ MusicEnvironment::State MusicEnvironment::reset() {
 }
 
 double MusicEnvironment::calculateReward(Action action, const State& state, double user_rating) const {
-    // Base reward from user rating (0-5 scale, normalized to -1 to 1)
-    double base_reward = (user_rating - 2.5) / 2.5;
-    
-    // Weather-mood compatibility bonus
-    double weather_bonus = getWeatherMoodCompatibility(
-        static_cast<WeatherCondition>(static_cast<int>(state.weather_condition)), action);
+    // Base reward from user rating (0-5 scale, normalized to -1 to 1), plus
+    // weather, time-of-day, genre consistency and temperature bonuses,
+    // clamped to [-1, 1]
+    int a = static_cast<int>(action);
+    return combineReward(a, state.temperature, state.genre_history[0], state.genre_history[1],
+                         state.genre_history[2], user_rating,
+                         WEATHER_COMPATIBILITY[weatherIndex(state.weather_condition)][a],
+                         TIME_COMPATIBILITY[timeBucket(state.hour_of_day * 24.0)][a]);
+}
+
+void MusicEnvironment::calculateRewardBatch(const StateBatch& states,
+                                            const std::vector<int>& actions,
+                                            const std::vector<double>& user_ratings,
+                                            std::vector<double>& rewards) const {
+    size_t n = states.size();
+    if (actions.size() != n || user_ratings.size() != n) {
+        throw std::invalid_argument("Batch size mismatch");
+    }
+    rewards.resize(n);
+    calculateRewardRange(states, actions.data(), user_ratings.data(), rewards.data(), 0, n);
+}
+
+void MusicEnvironment::calculateRewardRange(const StateBatch& states,
+                                            const int* actions,
+                                            const double* user_ratings,
+                                            double* rewards,
+                                            size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        if (actions[i] < 0 || actions[i] >= NUM_ACTIONS) {
+            throw std::invalid_argument("Action must be in range [0, 4]");
+        }
+    }
     
-    // Time-mood compatibility bonus
-    double time_bonus = getTimeMoodCompatibility(state.hour_of_day * 24.0, action);
+    const double* temperature = states.temperature.data();
+    const double* weather = states.weather_condition.data();
+    const double* hour = states.hour_of_day.data();
+    const double* h0 = states.genre_history[0].data();
+    const double* h1 = states.genre_history[1].data();
+    const double* h2 = states.genre_history[2].data();
     
-    // Genre consistency bonus (reward consistency with recent preferences)
-    double consistency_bonus = getGenreConsistency(state.genre_history, action);
+    // Process in blocks: table indices and the final arithmetic are
+    // branch-free SoA loops the compiler vectorizes (SSE/AVX natively,
+    // simd128 under Emscripten); only the table gathers stay scalar.
+    constexpr size_t BLOCK = 256;
+    int weather_idx[BLOCK], time_idx[BLOCK];
+    double weather_bonus[BLOCK], time_bonus[BLOCK];
     
-    // Temperature influence
-    double temp_bonus = 0.0;
-    if (state.temperature > 0.5 && (action == Action::ELECTRONIC_DANCE || action == Action::POP_HITS)) {
-        temp_bonus = 0.1; // Hot weather + energetic music
-    } else if (state.temperature < -0.5 && (action == Action::CHILL_LOFI || action == Action::JAZZ_SMOOTH)) {
-        temp_bonus = 0.1; // Cold weather + calm music
+    for (size_t block = begin; block < end; block += BLOCK) {
+        size_t count = std::min(BLOCK, end - block);
+        const int* a = actions + block;
+        
+        for (size_t j = 0; j < count; ++j) {
+            weather_idx[j] = weatherIndex(weather[block + j]) * NUM_ACTIONS + a[j];
+            time_idx[j] = timeBucket(hour[block + j] * 24.0) * NUM_ACTIONS + a[j];
+        }
+        for (size_t j = 0; j < count; ++j) {
+            weather_bonus[j] = WEATHER_COMPATIBILITY[0][weather_idx[j]];
+            time_bonus[j] = TIME_COMPATIBILITY[0][time_idx[j]];
+        }
+        for (size_t j = 0; j < count; ++j) {
+            size_t i = block + j;
+            rewards[i] = combineReward(a[j], temperature[i], h0[i], h1[i], h2[i],
+                                       user_ratings[i], weather_bonus[j], time_bonus[j]);
+        }
     }
-    
-    // Combine all factors
-    double total_reward = base_reward + 0.3 * weather_bonus + 0.2 * time_bonus + 
-                         0.2 * consistency_bonus + temp_bonus;
-    
-    // Clamp to [-1, 1] range
-    return std::max(-1.0, std::min(1.0, total_reward));
 }
 
-std::vector<double> MusicEnvironment::stateToVector(const State& state) const {
+std::vector<double> MusicEnvironment::stateToVector(const State& state) {
     return {
         state.temperature,
         state.weather_condition / 4.0,  // Normalize to [0,1]
@@ -72,7 +226,7 @@ std::vector<double> MusicEnvironment::stateToVector(const State& state) const {
     };
 }
 
-MusicEnvironment::State MusicEnvironment::vectorToState(const std::vector<double>& vec) const {
+MusicEnvironment::State MusicEnvironment::vectorToState(const std::vector<double>& vec) {
     if (vec.size() != 8) {
         throw std::invalid_argument("State vector must have exactly 8 elements");
     }
@@ -109,117 +263,16 @@ MusicEnvironment::Action MusicEnvironment::intToAction(int action_int) {
 }
 
 double MusicEnvironment::getWeatherMoodCompatibility(WeatherCondition weather, Action action) const {
-    // Define weather-music compatibility matrix
-    switch (weather) {
-        case WeatherCondition::SUNNY:
-            switch (action) {
-                case Action::POP_HITS: return 0.8;
-                case Action::ELECTRONIC_DANCE: return 0.7;
-                case Action::ROCK_ENERGY: return 0.6;
-                case Action::JAZZ_SMOOTH: return 0.4;
-                case Action::CHILL_LOFI: return 0.3;
-            }
-            break;
-            
-        case WeatherCondition::CLOUDY:
-            switch (action) {
-                case Action::CHILL_LOFI: return 0.8;
-                case Action::JAZZ_SMOOTH: return 0.7;
-                case Action::POP_HITS: return 0.5;
-                case Action::ROCK_ENERGY: return 0.4;
-                case Action::ELECTRONIC_DANCE: return 0.3;
-            }
-            break;
-            
-        case WeatherCondition::RAINY:
-            switch (action) {
-                case Action::CHILL_LOFI: return 0.9;
-                case Action::JAZZ_SMOOTH: return 0.8;
-                case Action::POP_HITS: return 0.3;
-                case Action::ROCK_ENERGY: return 0.2;
-                case Action::ELECTRONIC_DANCE: return 0.1;
-            }
-            break;
-            
-        case WeatherCondition::SNOWY:
-            switch (action) {
-                case Action::JAZZ_SMOOTH: return 0.8;
-                case Action::CHILL_LOFI: return 0.7;
-                case Action::POP_HITS: return 0.4;
-                case Action::ROCK_ENERGY: return 0.3;
-                case Action::ELECTRONIC_DANCE: return 0.2;
-            }
-            break;
-            
-        case WeatherCondition::STORMY:
-            switch (action) {
-                case Action::ROCK_ENERGY: return 0.8;
-                case Action::ELECTRONIC_DANCE: return 0.6;
-                case Action::CHILL_LOFI: return 0.5;
-                case Action::JAZZ_SMOOTH: return 0.4;
-                case Action::POP_HITS: return 0.3;
-            }
-            break;
-    }
-    return 0.5; // Default compatibility
+    return WEATHER_COMPATIBILITY[weatherIndex(static_cast<int>(weather))][static_cast<int>(action)];
 }
 
 double MusicEnvironment::getTimeMoodCompatibility(double hour, Action action) const {
-    // Early morning (5-9): Gentle wake-up music
-    if (hour >= 5 && hour < 9) {
-        switch (action) {
-            case Action::CHILL_LOFI: return 0.8;
-            case Action::JAZZ_SMOOTH: return 0.7;
-            case Action::POP_HITS: return 0.5;
-            case Action::ROCK_ENERGY: return 0.2;
-            case Action::ELECTRONIC_DANCE: return 0.1;
-        }
-    }
-    // Work hours (9-17): Focus music
-    else if (hour >= 9 && hour < 17) {
-        switch (action) {
-            case Action::CHILL_LOFI: return 0.9;
-            case Action::JAZZ_SMOOTH: return 0.6;
-            case Action::POP_HITS: return 0.4;
-            case Action::ROCK_ENERGY: return 0.3;
-            case Action::ELECTRONIC_DANCE: return 0.2;
-        }
-    }
-    // Evening (17-22): Energetic or relaxing
-    else if (hour >= 17 && hour < 22) {
-        switch (action) {
-            case Action::POP_HITS: return 0.8;
-            case Action::ROCK_ENERGY: return 0.7;
-            case Action::ELECTRONIC_DANCE: return 0.6;
-            case Action::JAZZ_SMOOTH: return 0.5;
-            case Action::CHILL_LOFI: return 0.4;
-        }
-    }
-    // Night (22-5): Calm, relaxing music
-    else {
-        switch (action) {
-            case Action::CHILL_LOFI: return 0.9;
-            case Action::JAZZ_SMOOTH: return 0.8;
-            case Action::POP_HITS: return 0.3;
-            case Action::ROCK_ENERGY: return 0.1;
-            case Action::ELECTRONIC_DANCE: return 0.1;
-        }
-    }
-    return 0.5; // Default compatibility
+    return TIME_COMPATIBILITY[timeBucket(hour)][static_cast<int>(action)];
 }
 
-double MusicEnvironment::getGenreConsistency(const std::array<double, 3>& history, Action action) const {
-    // Convert action to genre preference value
-    double action_value = static_cast<double>(action) / 4.0; // Normalize to [0,1]
-    
-    // Calculate similarity to recent history
-    double similarity = 0.0;
-    for (int i = 0; i < 3; ++i) {
-        double weight = 1.0 - (i * 0.2); // More recent history has higher weight
-        similarity += weight * (1.0 - std::abs(action_value - history[i]));
-    }
-    
-    return similarity / 3.0; // Average similarity
+double MusicEnvironment::getGenreConsistency(const std::array<double, 3>& history, Action action) {
+    // Similarity of the action's normalized genre value to recent history
+    return genreConsistency(static_cast<double>(action) / 4.0, history[0], history[1], history[2]);
 }
 
 } // namespace MusicAI
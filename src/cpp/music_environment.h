@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <array>
 #include <random>
+#include <string>
 
 namespace MusicAI {
 
@@ -17,6 +19,21 @@ public:
         std::array<double, 3> genre_history; // Recent genre preferences
     };
     
+    // Structure-of-arrays layout of many states for batched evaluation
+    struct StateBatch {
+        std::vector<double> temperature;
+        std::vector<double> weather_condition;
+        std::vector<double> hour_of_day;
+        std::vector<double> day_of_week;
+        std::vector<double> user_mood;
+        std::array<std::vector<double>, 3> genre_history;
+        
+        size_t size() const { return temperature.size(); }
+        void resize(size_t n);
+        void set(size_t i, const State& state);
+        State get(size_t i) const;
+    };
+    
     enum class Action {
         CHILL_LOFI = 0,
         POP_HITS = 1,
@@ -38,7 +55,10 @@ private:
     State current_state_;
     
 public:
+    // Random states are seeded from std::random_device unless a seed is given
     MusicEnvironment();
+    explicit MusicEnvironment(uint64_t seed);
+    void seed(uint64_t seed);
     
     // Environment interface
     State reset();
@@ -48,18 +68,32 @@ public:
     // Reward calculation
     double calculateReward(Action action, const State& state, double user_rating) const;
     
-    // State utilities
-    std::vector<double> stateToVector(const State& state) const;
-    State vectorToState(const std::vector<double>& vec) const;
+    // Batched reward calculation, bit-identical to calculateReward per element
+    void calculateRewardBatch(const StateBatch& states,
+                              const std::vector<int>& actions,
+                              const std::vector<double>& user_ratings,
+                              std::vector<double>& rewards) const;
+    static void calculateRewardRange(const StateBatch& states,
+                                     const int* actions,
+                                     const double* user_ratings,
+                                     double* rewards,
+                                     size_t begin, size_t end);
+    
+    // State utilities (network input order, weather and mood scaled to [0, 1])
+    static std::vector<double> stateToVector(const State& state);
+    static State vectorToState(const std::vector<double>& vec);
     
     // Action utilities
     static std::string actionToString(Action action);
     static Action intToAction(int action_int);
     
+    // Similarity of an action's genre to the recent history, the consistency
+    // term of the reward (also used to score playlist continuations)
+    static double getGenreConsistency(const std::array<double, 3>& history, Action action);
+    
 private:
     double getWeatherMoodCompatibility(WeatherCondition weather, Action action) const;
     double getTimeMoodCompatibility(double hour, Action action) const;
-    double getGenreConsistency(const std::array<double, 3>& history, Action action) const;
 };
 
 } // namespace MusicAI
@@ -1,22 +1,55 @@
 #include "music_rl_engine.h"
+#include "dqn_update.h"
 #include <iostream>
 #include <algorithm>
-#include <random>
+#include <cmath>
+#include <stdexcept>
+#include <chrono>
 
 namespace MusicAI {
 
+namespace {
+
+NeuralNetwork::Architecture defaultArchitecture(const HeadConfig& head) {
+    NeuralNetwork::Architecture architecture;
+    architecture.head = head;
+    return architecture;
+}
+
+} // namespace
+
 MusicRecommendationDQN::MusicRecommendationDQN(double learning_rate,
                                                double epsilon,
                                                double epsilon_decay,
                                                double epsilon_min,
-                                               double gamma)
-    : epsilon_(epsilon), epsilon_decay_(epsilon_decay), epsilon_min_(epsilon_min),
+                                               double gamma,
+                                               const HeadConfig& head)
+    : MusicRecommendationDQN(defaultArchitecture(head), learning_rate, epsilon,
+                             epsilon_decay, epsilon_min, gamma) {
+}
+
+MusicRecommendationDQN::MusicRecommendationDQN(const NeuralNetwork::Architecture& architecture,
+                                               double learning_rate,
+                                               double epsilon,
+                                               double epsilon_decay,
+                                               double epsilon_min,
+                                               double gamma,
+                                               uint64_t seed)
+    : seed_(seed), rng_(seed), exploration_(ExplorationConfig(), NeuralNetwork::OUTPUT_SIZE),
+      capture_every_(0), capture_countdown_(0), capture_sequence_(0), model_version_(0),
+      epsilon_(epsilon), epsilon_decay_(epsilon_decay), epsilon_min_(epsilon_min),
       gamma_(gamma), target_update_freq_(100), training_step_(0) {
     
-    q_network_ = std::make_unique<NeuralNetwork>(learning_rate);
-    target_network_ = std::make_unique<NeuralNetwork>(learning_rate);
-    experience_buffer_ = std::make_unique<ExperienceBuffer>();
-    environment_ = std::make_unique<MusicEnvironment>();
+    // Replay updates, the Q-value cache and policy tables all read 8-feature states
+    if (architecture.input_size != NeuralNetwork::INPUT_SIZE) {
+        throw std::invalid_argument("DQN needs a network over the 8 session features");
+    }
+    q_network_ = std::make_unique<NeuralNetwork>(architecture, learning_rate, seed);
+    target_network_ = std::make_unique<NeuralNetwork>(architecture, learning_rate, seed);
+    experience_buffer_ = std::make_unique<ExperienceBuffer>(10000, seed + 1);
+    environment_ = std::make_unique<MusicEnvironment>(seed + 2);
+    session_tracker_ = std::make_unique<SessionTracker>();
+    n_step_ = std::make_unique<NStepAccumulator>(1, gamma_);
     
     // Initialize target network with same weights as main network
     updateTargetNetwork();
@@ -24,29 +57,35 @@ MusicRecommendationDQN::MusicRecommendationDQN(double learning_rate,
 
 MusicRecommendationDQN::~MusicRecommendationDQN() = default;
 
-int MusicRecommendationDQN::predict(const std::vector<double>& state) {
-    Eigen::VectorXd state_vec = vectorToEigen(state);
-    Eigen::VectorXd q_values = q_network_->forward(state_vec);
+void MusicRecommendationDQN::setSeed(uint64_t seed) {
+    seed_ = seed;
+    rng_.seed(seed);
+    experience_buffer_->seed(seed + 1);
+    environment_->seed(seed + 2);
+}
+
+int MusicRecommendationDQN::predict(const std::vector<double>& state, bool capture_activations) {
+    if (policy_table_) {
+        if (state.size() != static_cast<size_t>(PolicyTable::STATE_SIZE)) {
+            throw std::invalid_argument("State size mismatch");
+        }
+        return policy_table_->action(state.data());
+    }
     
-    // Epsilon-greedy action selection
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dis(0.0, 1.0);
+    Eigen::VectorXd state_vec = vectorToEigen(state);
+    Eigen::VectorXd q_values;
     
-    if (dis(gen) < epsilon_) {
-        // Explore: choose random action
-        std::uniform_int_distribution<int> action_dis(0, NeuralNetwork::OUTPUT_SIZE - 1);
-        return action_dis(gen);
+    if (shouldCapture(capture_activations)) {
+        auto snapshot = std::make_unique<ActivationSnapshot>();
+        snapshot->sequence = ++capture_sequence_;
+        q_values = evaluateState(state_vec, &snapshot->layers);
+        activation_mailbox_.publish(std::move(snapshot));
     } else {
-        // Exploit: choose action with highest Q-value
-        int best_action = 0;
-        for (int i = 1; i < q_values.size(); ++i) {
-            if (q_values(i) > q_values(best_action)) {
-                best_action = i;
-            }
-        }
-        return best_action;
+        q_values = cachedQValues(state_vec);
     }
+    
+    exploration_.selectActions(q_values, epsilon_, rng_, selected_actions_);
+    return selected_actions_[0];
 }
 
 void MusicRecommendationDQN::train(const std::vector<double>& state,
@@ -58,27 +97,174 @@ void MusicRecommendationDQN::train(const std::vector<double>& state,
     Eigen::VectorXd state_vec = vectorToEigen(state);
     Eigen::VectorXd next_state_vec = vectorToEigen(next_state);
     
-    Experience experience(state_vec, action, reward, next_state_vec, done);
+    learn(Experience(state_vec, action, reward, next_state_vec, done));
+}
+
+void MusicRecommendationDQN::learn(const Experience& experience) {
+    if (trainer_) {
+        trainer_->enqueue(experience);
+        advanceTrainingSteps(1);
+        return;
+    }
+    
     experience_buffer_->add(experience);
     
     // Train if we have enough experiences
-    if (experience_buffer_->canSample(32)) {
+    if (experience_buffer_->canSample(REPLAY_BATCH_SIZE)) {
         replayExperience();
     }
     
-    // Update target network periodically
-    if (++training_step_ % target_update_freq_ == 0) {
+    advanceTrainingSteps(1);
+}
+
+void MusicRecommendationDQN::learnPendingTransitions(uint64_t session_id) {
+    for (const auto& transition : pending_transitions_) {
+        n_step_->push(session_id, transition, n_step_transitions_);
+    }
+    pending_transitions_.clear();
+    
+    for (const auto& transition : n_step_transitions_) {
+        learn(transition);
+    }
+    n_step_transitions_.clear();
+}
+
+void MusicRecommendationDQN::observe(uint64_t session_id,
+                                     const std::vector<double>& state,
+                                     int action,
+                                     double reward,
+                                     double timestamp) {
+    session_tracker_->observe(session_id, vectorToEigen(state), action, reward,
+                              timestamp, pending_transitions_);
+    learnPendingTransitions(session_id);
+}
+
+void MusicRecommendationDQN::endSession(uint64_t session_id) {
+    session_tracker_->endSession(session_id, pending_transitions_);
+    learnPendingTransitions(session_id);
+}
+
+void MusicRecommendationDQN::expireIdleSessions(double now) {
+    for (uint64_t session_id : session_tracker_->idleSessions(now)) {
+        endSession(session_id);
+    }
+}
+
+void MusicRecommendationDQN::configureSessions(const SessionTracker::Config& config) {
+    // Pending events of open sessions are flushed as terminal transitions
+    for (uint64_t session_id : session_tracker_->sessionIds()) {
+        endSession(session_id);
+    }
+    session_tracker_ = std::make_unique<SessionTracker>(config);
+}
+
+void MusicRecommendationDQN::setNStepReturns(int n) {
+    for (uint64_t session_id : session_tracker_->sessionIds()) {
+        endSession(session_id);
+    }
+    n_step_ = std::make_unique<NStepAccumulator>(n, gamma_);
+}
+
+std::vector<int> MusicRecommendationDQN::predictBatch(const Eigen::MatrixXd& states, unsigned num_threads) {
+    Eigen::MatrixXd q_values = evaluateQ(states, num_threads);
+    
+    std::vector<int> actions;
+    exploration_.selectActions(q_values, epsilon_, rng_, actions);
+    return actions;
+}
+
+void MusicRecommendationDQN::setExplorationPolicy(const ExplorationConfig& config) {
+    exploration_ = ExplorationPolicy(config, NeuralNetwork::OUTPUT_SIZE);
+}
+
+void MusicRecommendationDQN::trainBatch(const Eigen::MatrixXd& states,
+                                        const std::vector<int>& actions,
+                                        const std::vector<double>& rewards,
+                                        const Eigen::MatrixXd& next_states,
+                                        const std::vector<bool>& dones) {
+    size_t n = static_cast<size_t>(states.cols());
+    if (actions.size() != n || rewards.size() != n || dones.size() != n ||
+        next_states.cols() != states.cols()) {
+        throw std::invalid_argument("Batch size mismatch");
+    }
+    
+    if (trainer_) {
+        for (size_t i = 0; i < n; ++i) {
+            trainer_->enqueue(Experience(states.col(i), actions[i], rewards[i],
+                                         next_states.col(i), dones[i]));
+        }
+        advanceTrainingSteps(static_cast<int>(n));
+        return;
+    }
+    
+    for (size_t i = 0; i < n; ++i) {
+        experience_buffer_->add(Experience(states.col(i), actions[i], rewards[i],
+                                           next_states.col(i), dones[i]));
+    }
+    
+    // Replay ratio of one: each ingested transition is sampled once on average,
+    // in minibatches of REPLAY_BATCH_SIZE
+    if (experience_buffer_->canSample(REPLAY_BATCH_SIZE)) {
+        size_t replays = (n + REPLAY_BATCH_SIZE - 1) / REPLAY_BATCH_SIZE;
+        for (size_t r = 0; r < replays; ++r) {
+            replayExperience();
+        }
+    }
+    
+    advanceTrainingSteps(static_cast<int>(n));
+}
+
+void MusicRecommendationDQN::advanceTrainingSteps(int steps) {
+    // Update target network each time a multiple of target_update_freq_ is crossed
+    // (the background trainer keeps its own target network)
+    int previous_step = training_step_;
+    training_step_ += steps;
+    if (!trainer_ && training_step_ / target_update_freq_ != previous_step / target_update_freq_) {
         updateTargetNetwork();
     }
     
     // Decay epsilon
     if (epsilon_ > epsilon_min_) {
-        epsilon_ *= epsilon_decay_;
+        epsilon_ = std::max(epsilon_min_, epsilon_ * std::pow(epsilon_decay_, steps));
     }
 }
 
+bool MusicRecommendationDQN::shouldCapture(bool requested) {
+    if (requested) {
+        return true;
+    }
+    if (capture_every_ == 0) {
+        return false;
+    }
+    if (--capture_countdown_ == 0) {
+        capture_countdown_ = capture_every_;
+        return true;
+    }
+    return false;
+}
+
+void MusicRecommendationDQN::setActivationSampling(uint32_t every_n) {
+    capture_every_ = every_n;
+    capture_countdown_ = every_n;
+}
+
+bool MusicRecommendationDQN::pollActivations() {
+    std::unique_ptr<ActivationSnapshot> snapshot = activation_mailbox_.take();
+    if (!snapshot) {
+        return false;
+    }
+    polled_activations_ = std::move(snapshot);
+    summarizeLayers(polled_activations_->layers, layer_summaries_);
+    return true;
+}
+
 std::vector<double> MusicRecommendationDQN::getActivations(int layer) const {
-    return q_network_->getActivations(layer);
+    if (!polled_activations_ || layer < 0 ||
+        layer >= static_cast<int>(polled_activations_->layers.size())) {
+        return {};
+    }
+    const Eigen::VectorXd& activations = polled_activations_->layers[layer];
+    return std::vector<double>(activations.data(), activations.data() + activations.size());
 }
 
 std::vector<NeuralNetwork::LayerInfo> MusicRecommendationDQN::getLayerInfo() const {
@@ -87,17 +273,169 @@ std::vector<NeuralNetwork::LayerInfo> MusicRecommendationDQN::getLayerInfo() con
 
 std::vector<double> MusicRecommendationDQN::getQValues(const std::vector<double>& state) const {
     Eigen::VectorXd state_vec = vectorToEigen(state);
-    Eigen::VectorXd q_values = q_network_->forward(state_vec);
-    return eigenToVector(q_values);
+    return eigenToVector(cachedQValues(state_vec));
+}
+
+Eigen::MatrixXd MusicRecommendationDQN::evaluateQ(const Eigen::MatrixXd& states, unsigned num_threads) const {
+    if (trainer_) {
+        std::shared_ptr<const NeuralNetwork> snapshot = trainer_->snapshot();
+        return snapshot->forwardBatch(states, num_threads);
+    }
+    return q_network_->forwardBatch(states, num_threads);
+}
+
+void MusicRecommendationDQN::enableQValueCache(const QValueCache::Config& config) {
+    q_cache_ = std::make_unique<QValueCache>(config);
+}
+
+uint64_t MusicRecommendationDQN::getModelVersion() const {
+    // Local weight changes advance the high word, trainer publishes the low word
+    uint64_t version = model_version_ << 32;
+    if (trainer_) {
+        version |= trainer_->publishCount() & 0xFFFFFFFFull;
+    }
+    return version;
+}
+
+Eigen::VectorXd MusicRecommendationDQN::cachedQValues(const Eigen::VectorXd& state) const {
+    if (!q_cache_) {
+        return evaluateState(state);
+    }
+    
+    // Read the version before evaluating: a publish in between can only tag
+    // newer values with an older version, which later lookups simply miss
+    uint64_t version = getModelVersion();
+    QValueCache::Key key = q_cache_->makeKey(state);
+    Eigen::VectorXd q_values;
+    if (!q_cache_->lookup(key, version, q_values)) {
+        q_values = evaluateState(state);
+        q_cache_->insert(key, version, q_values);
+    }
+    return q_values;
+}
+
+Eigen::VectorXd MusicRecommendationDQN::evaluateState(const Eigen::VectorXd& state,
+                                                      std::vector<Eigen::VectorXd>* activations) const {
+    if (trainer_) {
+        std::shared_ptr<const NeuralNetwork> snapshot = trainer_->snapshot();
+        return snapshot->forward(state, activations);
+    }
+    return q_network_->forward(state, activations);
 }
 
 void MusicRecommendationDQN::saveModel(const std::string& filepath) const {
+    if (trainer_) {
+        trainer_->flush();
+        trainer_->snapshot()->saveWeights(filepath);
+        return;
+    }
     q_network_->saveWeights(filepath);
 }
 
 void MusicRecommendationDQN::loadModel(const std::string& filepath) {
-    q_network_->loadWeights(filepath);
+    // Load into a copy so a rejected file leaves the serving network as it was
+    NeuralNetwork loaded(*q_network_);
+    loaded.loadWeights(filepath);
+    if (loaded.getInputSize() != NeuralNetwork::INPUT_SIZE) {
+        throw std::invalid_argument("DQN needs a network over the 8 session features: " + filepath);
+    }
+    
+    if (trainer_) {
+        // Restart the trainer from the loaded weights
+        AsyncTrainer::Config config = trainer_->getConfig();
+        stopBackgroundTraining();
+        *q_network_ = loaded;
+        updateTargetNetwork();
+        startBackgroundTraining(config);
+        return;
+    }
+    *q_network_ = loaded;
     updateTargetNetwork();
+    ++model_version_;
+}
+
+void MusicRecommendationDQN::setPruningSchedule(const MagnitudePruner::Config& config) {
+    pruner_ = std::make_unique<MagnitudePruner>(config);
+}
+
+void MusicRecommendationDQN::setSparseInference(double density_threshold) {
+    if (trainer_) {
+        throw std::logic_error("Stop background training before changing sparse inference");
+    }
+    q_network_->setSparseInference(density_threshold);
+}
+
+void MusicRecommendationDQN::loadPolicyTable(const std::string& filepath) {
+    policy_table_ = std::make_shared<const PolicyTable>(PolicyTable::load(filepath));
+}
+
+void MusicRecommendationDQN::addShadowModel(std::shared_ptr<const NeuralNetwork> candidate) {
+    if (candidate->getInputSize() != NeuralNetwork::INPUT_SIZE ||
+        candidate->getHead().numActions() != q_network_->getHead().numActions()) {
+        throw std::invalid_argument("Shadow model must take the session features and score the same actions");
+    }
+    shadow_models_.push_back(std::move(candidate));
+}
+
+void MusicRecommendationDQN::loadShadowModel(const std::string& filepath) {
+    auto candidate = std::make_shared<NeuralNetwork>();
+    candidate->loadWeights(filepath);
+    addShadowModel(std::move(candidate));
+}
+
+void MusicRecommendationDQN::clearShadowModels() {
+    shadow_models_.clear();
+}
+
+const Eigen::MatrixXd& MusicRecommendationDQN::scoreShadow(const std::vector<double>& state) {
+    Eigen::VectorXd input = vectorToEigen(state);
+    Eigen::VectorXd serving = evaluateState(input);
+    shadow_scores_.resize(serving.size(), static_cast<Eigen::Index>(shadow_models_.size() + 1));
+    shadow_scores_.col(0) = serving;
+    for (size_t k = 0; k < shadow_models_.size(); ++k) {
+        shadow_scores_.col(static_cast<Eigen::Index>(k + 1)) = shadow_models_[k]->forward(input);
+    }
+    return shadow_scores_;
+}
+
+std::vector<Eigen::MatrixXd> MusicRecommendationDQN::scoreShadowBatch(const Eigen::MatrixXd& states,
+                                                                      unsigned num_threads) {
+    std::vector<Eigen::MatrixXd> q_values;
+    q_values.reserve(shadow_models_.size() + 1);
+    q_values.push_back(evaluateQ(states, num_threads));
+    for (const auto& candidate : shadow_models_) {
+        q_values.push_back(candidate->forwardBatch(states, num_threads));
+    }
+    return q_values;
+}
+
+void MusicRecommendationDQN::startBackgroundTraining(const AsyncTrainer::Config& config) {
+    if (trainer_) {
+        stopBackgroundTraining();
+    }
+    AsyncTrainer::Config trainer_config = config;
+    trainer_config.gamma = gamma_;
+    trainer_config.seed = seed_ + 1;
+    trainer_ = std::make_unique<AsyncTrainer>(*q_network_, trainer_config);
+    ++model_version_;
+}
+
+void MusicRecommendationDQN::stopBackgroundTraining() {
+    if (!trainer_) {
+        return;
+    }
+    trainer_->flush();
+    *q_network_ = *trainer_->snapshot();
+    trainer_.reset();
+    updateTargetNetwork();
+    ++model_version_;
+}
+
+AsyncTrainer::Stats MusicRecommendationDQN::getBackgroundTrainingStats() const {
+    if (!trainer_) {
+        return AsyncTrainer::Stats{0, 0, 0, 0, 0};
+    }
+    return trainer_->getStats();
 }
 
 void MusicRecommendationDQN::updateTargetNetwork() {
@@ -122,39 +460,12 @@ std::vector<double> MusicRecommendationDQN::eigenToVector(const Eigen::VectorXd&
     return std_vec;
 }
 
-void MusicRecommendationDQN::replayExperience() {
-    const int batch_size = 32;
-    auto experiences = experience_buffer_->sample(batch_size);
-    
-    std::vector<Eigen::VectorXd> states, targets;
-    
-    for (const auto& exp : experiences) {
-        Eigen::VectorXd current_q = q_network_->forward(exp.state);
-        Eigen::VectorXd target_q = current_q;
-        
-        if (exp.done) {
-            target_q(exp.action) = exp.reward;
-        } else {
-            // Double DQN: use main network to select action, target network to evaluate
-            Eigen::VectorXd next_q_main = q_network_->forward(exp.next_state);
-            Eigen::VectorXd next_q_target = target_network_->forward(exp.next_state);
-            
-            int best_action = 0;
-            for (int i = 1; i < next_q_main.size(); ++i) {
-                if (next_q_main(i) > next_q_main(best_action)) {
-                    best_action = i;
-                }
-            }
-            
-            target_q(exp.action) = exp.reward + gamma_ * next_q_target(best_action);
-        }
-        
-        states.push_back(exp.state);
-        targets.push_back(target_q);
+void MusicRecommendationDQN::replayExperience(size_t batch_size) {
+    doubleDQNUpdate(*q_network_, *target_network_, experience_buffer_->sample(batch_size), gamma_);
+    if (pruner_) {
+        pruner_->step(*q_network_);
     }
-    
-    // Update network with batch
-    q_network_->updateWeights(states, targets);
+    ++model_version_;
 }
 
 } // namespace MusicAI
@@ -162,6 +473,17 @@ void MusicRecommendationDQN::replayExperience() {
 // Global instance for C interface
 static std::unique_ptr<MusicAI::MusicRecommendationDQN> g_engine;
 
+// Wall-clock seconds for session timeouts
+static double nowSeconds() {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Sessions the client never ends are expired from trainSession, at most once
+// per interval since a sweep visits every open session
+static constexpr double IDLE_SWEEP_INTERVAL_SECONDS = 60.0;
+static double g_last_idle_sweep = 0.0;
+
 // C interface implementation
 extern "C" {
 
@@ -169,6 +491,11 @@ void initialize() {
     g_engine = std::make_unique<MusicAI::MusicRecommendationDQN>();
 }
 
+void initializeWithArchitecture(const char* spec) {
+    g_engine = std::make_unique<MusicAI::MusicRecommendationDQN>(
+        MusicAI::NeuralNetwork::Architecture::parse(spec));
+}
+
 int predict(double temperature, double weather_condition, double hour,
            double day_of_week, double user_mood, double genre_history_1,
            double genre_history_2, double genre_history_3) {
@@ -190,6 +517,15 @@ void train(double temperature, double weather_condition, double hour,
           double genre_history_2, double genre_history_3,
           int action, double reward) {
     
+    trainSession(0, temperature, weather_condition, hour, day_of_week, user_mood,
+                 genre_history_1, genre_history_2, genre_history_3, action, reward);
+}
+
+void trainSession(int session_id, double temperature, double weather_condition,
+                  double hour, double day_of_week, double user_mood,
+                  double genre_history_1, double genre_history_2,
+                  double genre_history_3, int action, double reward) {
+    
     if (!g_engine) {
         initialize();
     }
@@ -199,9 +535,28 @@ void train(double temperature, double weather_condition, double hour,
         user_mood, genre_history_1, genre_history_2, genre_history_3
     };
     
-    // For simplicity, we'll use the same state as next_state
-    // In a real implementation, this would be the actual next state
-    g_engine->train(state, action, reward, state, false);
+    double now = nowSeconds();
+    if (now - g_last_idle_sweep >= IDLE_SWEEP_INTERVAL_SECONDS) {
+        g_engine->expireIdleSessions(now);
+        g_last_idle_sweep = now;
+    }
+    
+    // The transition completes when this session's next event supplies s'
+    g_engine->observe(static_cast<uint64_t>(session_id), state, action, reward, now);
+}
+
+void endSession(int session_id) {
+    if (!g_engine) {
+        initialize();
+    }
+    g_engine->endSession(static_cast<uint64_t>(session_id));
+}
+
+void setActivationSampling(int every_n) {
+    if (!g_engine) {
+        initialize();
+    }
+    g_engine->setActivationSampling(static_cast<uint32_t>(std::max(every_n, 0)));
 }
 
 double* getActivations(int layer, int* size) {
@@ -209,6 +564,7 @@ double* getActivations(int layer, int* size) {
         initialize();
     }
     
+    g_engine->pollActivations();
     auto activations = g_engine->getActivations(layer);
     *size = static_cast<int>(activations.size());
     
@@ -225,10 +581,28 @@ double* getActivations(int layer, int* size) {
     return result;
 }
 
+const MusicAI::LayerSummary* getLayerSummaries(int* count) {
+    if (!g_engine) {
+        initialize();
+    }
+    
+    g_engine->pollActivations();
+    const auto& summaries = g_engine->getLayerSummaries();
+    *count = static_cast<int>(summaries.size());
+    return summaries.empty() ? nullptr : summaries.data();
+}
+
 void freeActivations(double* activations) {
     delete[] activations;
 }
 
+void setRandomSeed(unsigned int seed) {
+    if (!g_engine) {
+        initialize();
+    }
+    g_engine->setSeed(seed);
+}
+
 void saveModel(const char* filepath) {
     if (!g_engine) {
         initialize();
@@ -243,4 +617,55 @@ void loadModel(const char* filepath) {
     g_engine->loadModel(std::string(filepath));
 }
 
+void loadPolicyTable(const char* filepath) {
+    if (!g_engine) {
+        initialize();
+    }
+    g_engine->loadPolicyTable(std::string(filepath));
+}
+
+void loadShadowModel(const char* filepath) {
+    if (!g_engine) {
+        initialize();
+    }
+    g_engine->loadShadowModel(std::string(filepath));
+}
+
+void clearShadowModels() {
+    if (g_engine) {
+        g_engine->clearShadowModels();
+    }
+}
+
+const double* scoreShadow(double temperature, double weather_condition, double hour,
+                          double day_of_week, double user_mood, double genre_history_1,
+                          double genre_history_2, double genre_history_3, int* count) {
+    if (!g_engine) {
+        initialize();
+    }
+    
+    std::vector<double> state = {
+        temperature, weather_condition, hour, day_of_week,
+        user_mood, genre_history_1, genre_history_2, genre_history_3
+    };
+    const Eigen::MatrixXd& scores = g_engine->scoreShadow(state);
+    *count = static_cast<int>(scores.size());
+    return scores.data();
+}
+
+void startBackgroundTraining(double updates_per_event) {
+    if (!g_engine) {
+        initialize();
+    }
+    MusicAI::AsyncTrainer::Config config;
+    config.updates_per_event = updates_per_event;
+    g_engine->startBackgroundTraining(config);
+}
+
+void stopBackgroundTraining() {
+    if (g_engine) {
+        g_engine->stopBackgroundTraining();
+    }
+}
+
 }
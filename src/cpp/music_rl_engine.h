@@ -3,16 +3,57 @@
 #include "neural_network.h"
 #include "experience_buffer.h"
 #include "music_environment.h"
+#include "session_tracker.h"
+#include "n_step_accumulator.h"
+#include "async_trainer.h"
+#include "exploration_policy.h"
+#include "fast_rng.h"
+#include "activation_mailbox.h"
+#include "layer_summary.h"
+#include "q_value_cache.h"
+#include "policy_table.h"
+#include "magnitude_pruner.h"
+#include "recommendation_policy.h"
 #include <memory>
 
 namespace MusicAI {
 
-class MusicRecommendationDQN {
+class MusicRecommendationDQN : public RecommendationPolicy {
+public:
+    static constexpr size_t REPLAY_BATCH_SIZE = 32;
+    static constexpr uint64_t DEFAULT_SEED = 42;
+    
 private:
     std::unique_ptr<NeuralNetwork> q_network_;
     std::unique_ptr<NeuralNetwork> target_network_;
     std::unique_ptr<ExperienceBuffer> experience_buffer_;
     std::unique_ptr<MusicEnvironment> environment_;
+    std::unique_ptr<SessionTracker> session_tracker_;
+    std::unique_ptr<NStepAccumulator> n_step_;
+    std::vector<Experience> pending_transitions_;  // Scratch for tracker output
+    std::vector<Experience> n_step_transitions_;   // Scratch for accumulator output
+    std::unique_ptr<AsyncTrainer> trainer_;        // Set while training in the background
+    uint64_t seed_;                                // Weights, replay sampling and environment streams
+    FastRng rng_;                                  // Seeded once; drives action selection
+    ExplorationPolicy exploration_;
+    std::vector<int> selected_actions_;            // Scratch for single-state predict
+    
+    // Visualization capture: off unless sampled or requested per call
+    ActivationMailbox activation_mailbox_;
+    std::unique_ptr<ActivationSnapshot> polled_activations_;  // Latest capture taken by the UI
+    std::vector<LayerSummary> layer_summaries_;               // Summaries of that capture
+    uint32_t capture_every_;      // Capture one predict in N (0 = never)
+    uint32_t capture_countdown_;
+    uint64_t capture_sequence_;
+    
+    std::unique_ptr<QValueCache> q_cache_;  // Optional, in front of getQValues/predict
+    uint64_t model_version_;                // Bumped whenever local weights change
+    std::shared_ptr<const PolicyTable> policy_table_;  // Lookup-table serving mode
+    std::unique_ptr<MagnitudePruner> pruner_;          // Optional pruning during replay
+    
+    // Shadow scoring: candidates evaluated next to the serving model
+    std::vector<std::shared_ptr<const NeuralNetwork>> shadow_models_;
+    Eigen::MatrixXd shadow_scores_;  // Latest scoreShadow result
     
     double epsilon_;           // Exploration rate
     double epsilon_decay_;
@@ -26,26 +67,122 @@ public:
                           double epsilon = 1.0,
                           double epsilon_decay = 0.995,
                           double epsilon_min = 0.01,
-                          double gamma = 0.95);
+                          double gamma = 0.95,
+                          const HeadConfig& head = HeadConfig());
+    
+    // Q-network layout from a descriptor, e.g. Architecture::parse("8-128-64-32-5");
+    // the input must be the 8 session features (std::invalid_argument otherwise)
+    explicit MusicRecommendationDQN(const NeuralNetwork::Architecture& architecture,
+                                    double learning_rate = 0.001,
+                                    double epsilon = 1.0,
+                                    double epsilon_decay = 0.995,
+                                    double epsilon_min = 0.01,
+                                    double gamma = 0.95,
+                                    uint64_t seed = DEFAULT_SEED);
     
-    ~MusicRecommendationDQN();
+    ~MusicRecommendationDQN() override;
     
-    // Main interface
-    int predict(const std::vector<double>& state);
+    // Main interface. capture_activations forces a visualization capture for
+    // this call regardless of the sampling rate.
+    int predict(const std::vector<double>& state) override { return predict(state, false); }
+    int predict(const std::vector<double>& state, bool capture_activations);
     void train(const std::vector<double>& state, 
               int action, 
               double reward, 
               const std::vector<double>& next_state, 
-              bool done);
+              bool done) override;
+    
+    // Session-aware training: per-listener feedback events are chained into
+    // (s, a, r, s', done) transitions before they reach the replay buffer
+    void observe(uint64_t session_id,
+                 const std::vector<double>& state,
+                 int action,
+                 double reward,
+                 double timestamp);
+    void endSession(uint64_t session_id);
+    void expireIdleSessions(double now);
+    void configureSessions(const SessionTracker::Config& config);
+    
+    // Session transitions are turned into n-step returns before replay (1 = off)
+    void setNStepReturns(int n);
+    int getNStepReturns() const { return n_step_->getN(); }
+    size_t getActiveSessions() const { return session_tracker_->activeSessions(); }
+    
+    // Batched interface (one state per column), used for simulator pretraining
+    std::vector<int> predictBatch(const Eigen::MatrixXd& states, unsigned num_threads = 1) override;
+    void trainBatch(const Eigen::MatrixXd& states,
+                    const std::vector<int>& actions,
+                    const std::vector<double>& rewards,
+                    const Eigen::MatrixXd& next_states,
+                    const std::vector<bool>& dones) override;
+    
+    // Determinism: weights are drawn from the constructor seed (DEFAULT_SEED
+    // unless given), and exploration, replay sampling (including the
+    // background trainer's) and the environment use streams derived from it.
+    // setSeed reseeds those streams without touching the weights, so a run is
+    // reproducible for a given seed apart from background-training timing.
+    void setSeed(uint64_t seed);
+    void setExplorationPolicy(const ExplorationConfig& config);
+    const ExplorationPolicy& getExplorationPolicy() const { return exploration_; }
+    
+    // Optional Q-value result cache keyed on the quantized state. Entries are
+    // tagged with getModelVersion(), so training updates, background publishes
+    // and model loads invalidate them implicitly.
+    void enableQValueCache(const QValueCache::Config& config);
+    void disableQValueCache() { q_cache_.reset(); }
+    const QValueCache* getQValueCache() const { return q_cache_.get(); }
+    uint64_t getModelVersion() const;
     
-    // For visualization
+    // Lookup-table serving: while a table is set, predict() returns its greedy
+    // action for the state's grid cell without running the network (no
+    // exploration, no activation capture). Training still updates the network.
+    void setPolicyTable(std::shared_ptr<const PolicyTable> table) { policy_table_ = std::move(table); }
+    void loadPolicyTable(const std::string& filepath);
+    void clearPolicyTable() { policy_table_.reset(); }
+    const PolicyTable* getPolicyTable() const { return policy_table_.get(); }
+    
+    // Iterative magnitude pruning, stepped after every replay update of the
+    // in-process learner (the background trainer keeps existing masks but
+    // does not advance the schedule). Sparse inference runs layers at or
+    // below the density threshold through sparse kernels.
+    void setPruningSchedule(const MagnitudePruner::Config& config);
+    void clearPruningSchedule() { pruner_.reset(); }
+    const MagnitudePruner* getPruningSchedule() const { return pruner_.get(); }
+    void setSparseInference(double density_threshold);
+    
+    // Shadow scoring for A/B tests: candidate models (same input and actions
+    // as the serving model) are scored on the same state, each through its
+    // own forward so fixed-size trunk kernels apply. Returns numActions x
+    // (1 + candidates); column 0 is the serving model as predict() sees it.
+    void addShadowModel(std::shared_ptr<const NeuralNetwork> candidate);
+    void loadShadowModel(const std::string& filepath);
+    void clearShadowModels();
+    size_t getShadowModelCount() const { return shadow_models_.size(); }
+    const Eigen::MatrixXd& scoreShadow(const std::vector<double>& state);
+    std::vector<Eigen::MatrixXd> scoreShadowBatch(const Eigen::MatrixXd& states, unsigned num_threads = 1);
+    
+    // For visualization: predict() publishes sampled captures to a mailbox;
+    // pollActivations() adopts the newest one (returns false if none arrived)
+    // and getActivations() reads layers from the adopted capture.
+    void setActivationSampling(uint32_t every_n);
+    uint32_t getActivationSampling() const { return capture_every_; }
+    bool pollActivations();
     std::vector<double> getActivations(int layer) const;
+    const std::vector<LayerSummary>& getLayerSummaries() const { return layer_summaries_; }
     std::vector<NeuralNetwork::LayerInfo> getLayerInfo() const;
-    std::vector<double> getQValues(const std::vector<double>& state) const;
+    std::vector<double> getQValues(const std::vector<double>& state) const override;
     
     // Model management
     void saveModel(const std::string& filepath) const;
-    void loadModel(const std::string& filepath);
+    void loadModel(const std::string& filepath);  // Same input rule as the constructor
+    
+    // Background training: train()/observe() only enqueue into the trainer,
+    // which replays on its own thread and publishes parameters that predict
+    // reads lock-free. Stopping drains the queue and adopts the trained weights.
+    void startBackgroundTraining(const AsyncTrainer::Config& config);
+    void stopBackgroundTraining();
+    bool isBackgroundTraining() const { return trainer_ != nullptr; }
+    AsyncTrainer::Stats getBackgroundTrainingStats() const;
     
     // Training utilities
     void updateTargetNetwork();
@@ -53,34 +190,73 @@ public:
     int getTrainingStep() const { return training_step_; }
     
 private:
+    Eigen::MatrixXd evaluateQ(const Eigen::MatrixXd& states, unsigned num_threads = 1) const;
+    Eigen::VectorXd evaluateState(const Eigen::VectorXd& state,
+                                  std::vector<Eigen::VectorXd>* activations = nullptr) const;
+    Eigen::VectorXd cachedQValues(const Eigen::VectorXd& state) const;
+    bool shouldCapture(bool requested);
     Eigen::VectorXd vectorToEigen(const std::vector<double>& vec) const;
     std::vector<double> eigenToVector(const Eigen::VectorXd& vec) const;
-    void replayExperience();
+    void learn(const Experience& experience);
+    void learnPendingTransitions(uint64_t session_id);
+    void replayExperience(size_t batch_size = REPLAY_BATCH_SIZE);
+    void advanceTrainingSteps(int steps);
 };
 
 } // namespace MusicAI
 
 // C interface for WebAssembly
 extern "C" {
-    // Initialize the engine
+    // Initialize the engine (optionally with an architecture spec string)
     void initialize();
+    void initializeWithArchitecture(const char* spec);
     
     // Prediction interface
     int predict(double temperature, double weather_condition, double hour, 
                double day_of_week, double user_mood, double genre_history_1,
                double genre_history_2, double genre_history_3);
     
-    // Training interface
+    // Training interface (single anonymous listening session)
     void train(double temperature, double weather_condition, double hour,
               double day_of_week, double user_mood, double genre_history_1,
               double genre_history_2, double genre_history_3,
               int action, double reward);
     
-    // Visualization interface
+    // Session-aware training interface. Sessions idle past the tracker's
+    // timeout are ended from trainSession (swept at most once a minute).
+    void trainSession(int session_id, double temperature, double weather_condition,
+                      double hour, double day_of_week, double user_mood,
+                      double genre_history_1, double genre_history_2,
+                      double genre_history_3, int action, double reward);
+    void endSession(int session_id);
+    
+    // Visualization interface (capture every n-th prediction, 0 = off)
+    void setActivationSampling(int every_n);
     double* getActivations(int layer, int* size);
+    
+    // Summaries of every layer of the latest capture. Points into engine-owned
+    // memory that stays valid until the next call; do not free.
+    const MusicAI::LayerSummary* getLayerSummaries(int* count);
     void freeActivations(double* activations);
     
-    // Model management
+    // Reseed the engine's exploration generator
+    void setRandomSeed(unsigned int seed);
+    
+    // Model management (loadPolicyTable switches predict to table lookups)
     void saveModel(const char* filepath);
     void loadModel(const char* filepath);
+    void loadPolicyTable(const char* filepath);
+    
+    // Shadow scoring: Q-values of the serving model and every loaded candidate
+    // (column-major, numActions per model). Points into engine-owned memory
+    // that stays valid until the next call; do not free.
+    void loadShadowModel(const char* filepath);
+    void clearShadowModels();
+    const double* scoreShadow(double temperature, double weather_condition, double hour,
+                              double day_of_week, double user_mood, double genre_history_1,
+                              double genre_history_2, double genre_history_3, int* count);
+    
+    // Background training (native or pthread-enabled builds)
+    void startBackgroundTraining(double updates_per_event);
+    void stopBackgroundTraining();
 }
@@ -0,0 +1,87 @@
+#include "n_step_accumulator.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+NStepAccumulator::NStepAccumulator(int n, double gamma)
+    : n_(n), gamma_(gamma) {
+    if (n < 1) {
+        throw std::invalid_argument("N-step horizon must be at least 1");
+    }
+    gamma_powers_.resize(n);
+    for (int k = 0; k < n; ++k) {
+        gamma_powers_[k] = std::pow(gamma, k);
+    }
+}
+
+void NStepAccumulator::push(uint64_t session_id, const Experience& transition,
+                            std::vector<Experience>& out) {
+    if (n_ == 1) {
+        out.push_back(transition);
+        return;
+    }
+    
+    Ring& ring = rings_[session_id];
+    if (ring.slots.empty()) {
+        ring.slots.resize(n_);
+    }
+    
+    // Append r_t at offset `count`: G += gamma^count * r_t
+    Slot& tail = ring.slots[(ring.head + ring.count) % n_];
+    tail.state = transition.state;
+    tail.action = transition.action;
+    tail.reward = transition.reward;
+    ring.discounted_return += gamma_powers_[ring.count] * transition.reward;
+    ++ring.count;
+    
+    if (transition.done) {
+        flush(ring, transition.next_state, out);
+        rings_.erase(session_id);
+        return;
+    }
+    
+    if (ring.count == n_) {
+        const Slot& oldest = ring.slots[ring.head];
+        out.emplace_back(oldest.state, oldest.action, ring.discounted_return,
+                         transition.next_state, false, n_);
+        
+        // Drop r_head: G = (G - r_head) / gamma. Recompute exactly whenever
+        // the ring wraps so rounding error cannot accumulate.
+        double dropped = oldest.reward;
+        ring.head = (ring.head + 1) % n_;
+        --ring.count;
+        if (ring.head == 0 || gamma_ == 0.0) {
+            ring.discounted_return = recomputeReturn(ring);
+        } else {
+            ring.discounted_return = (ring.discounted_return - dropped) / gamma_;
+        }
+    }
+}
+
+void NStepAccumulator::flush(Ring& ring, const Eigen::VectorXd& final_state,
+                             std::vector<Experience>& out) {
+    // Terminal: every remaining slot gets its (shorter) full return
+    double discounted_return = 0.0;
+    std::vector<double> returns(ring.count);
+    for (int k = ring.count - 1; k >= 0; --k) {
+        discounted_return = ring.slots[(ring.head + k) % n_].reward + gamma_ * discounted_return;
+        returns[k] = discounted_return;
+    }
+    for (int k = 0; k < ring.count; ++k) {
+        const Slot& slot = ring.slots[(ring.head + k) % n_];
+        out.emplace_back(slot.state, slot.action, returns[k], final_state, true, ring.count - k);
+    }
+    ring.count = 0;
+    ring.discounted_return = 0.0;
+}
+
+double NStepAccumulator::recomputeReturn(const Ring& ring) const {
+    double discounted_return = 0.0;
+    for (int k = 0; k < ring.count; ++k) {
+        discounted_return += gamma_powers_[k] * ring.slots[(ring.head + k) % n_].reward;
+    }
+    return discounted_return;
+}
+
+} // namespace MusicAI
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "experience_buffer.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+// Converts per-session one-step transitions into n-step transitions
+// (s_t, a_t, sum_k gamma^k r_{t+k}, s_{t+n}) using a fixed-size ring per
+// session. The discounted return is maintained incrementally, so each event
+// costs O(1); episode ends flush the shorter tails.
+class NStepAccumulator {
+private:
+    struct Slot {
+        Eigen::VectorXd state;
+        int action;
+        double reward;
+    };
+    
+    struct Ring {
+        std::vector<Slot> slots;
+        int head = 0;
+        int count = 0;
+        double discounted_return = 0.0;  // sum_k gamma^k r_{head+k}
+    };
+    
+    int n_;
+    double gamma_;
+    std::vector<double> gamma_powers_;  // gamma^0 .. gamma^(n-1)
+    std::unordered_map<uint64_t, Ring> rings_;
+    
+public:
+    NStepAccumulator(int n, double gamma);
+    
+    // Consumes the next one-step transition of a session and appends any
+    // completed n-step transitions to `out`
+    void push(uint64_t session_id, const Experience& transition, std::vector<Experience>& out);
+    
+    int getN() const { return n_; }
+    size_t activeSessions() const { return rings_.size(); }
+    void clear() { rings_.clear(); }
+    
+private:
+    void flush(Ring& ring, const Eigen::VectorXd& final_state, std::vector<Experience>& out);
+    double recomputeReturn(const Ring& ring) const;
+};
+
+} // namespace MusicAI
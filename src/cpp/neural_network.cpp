@@ -1,25 +1,236 @@
 #include "neural_network.h"
+#include "parallel_for.h"
+#include <algorithm>
 #include <random>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <numeric>
+#include <stdexcept>
 
 namespace MusicAI {
 
-NeuralNetwork::NeuralNetwork(double learning_rate) 
-    : learning_rate_(learning_rate) {
-    initializeWeights();
+namespace {
+
+// Model files start with this tag ("MQNN") followed by a format version.
+// Files without it are the original headerless format: a dense stack whose
+// last layer is a linear output layer. Version 1 has no architecture
+// descriptor (all hidden layers ReLU); version 2 adds one after the head.
+constexpr uint32_t MODEL_MAGIC = 0x4E4E514D;
+constexpr uint32_t MODEL_VERSION = 2;
+constexpr int MAX_LAYER_SIZE = 1 << 16;
+
+using Activation = NeuralNetwork::Activation;
+
+NeuralNetwork::Architecture trunkArchitecture(const std::vector<int>& hidden_sizes, const HeadConfig& head) {
+    NeuralNetwork::Architecture architecture;
+    architecture.hidden_sizes = hidden_sizes;
+    architecture.head = head;
+    return architecture;
+}
+
+bool validActivation(int code) {
+    return code >= static_cast<int>(Activation::RELU) && code <= static_cast<int>(Activation::LINEAR);
+}
+
+template <typename Matrix>
+void activate(Matrix& values, Activation activation) {
+    switch (activation) {
+        case Activation::RELU:
+            values = values.cwiseMax(0.0);
+            break;
+        case Activation::TANH:
+            values = values.array().tanh().matrix();
+            break;
+        case Activation::LINEAR:
+            break;
+    }
+}
+
+// Scales delta by the activation derivative, expressed through the layer output
+void activationBackward(Eigen::MatrixXd& delta, const Eigen::MatrixXd& outputs, Activation activation) {
+    switch (activation) {
+        case Activation::RELU:
+            delta.array() *= (outputs.array() > 0.0).cast<double>();
+            break;
+        case Activation::TANH:
+            delta.array() *= 1.0 - outputs.array().square();
+            break;
+        case Activation::LINEAR:
+            break;
+    }
+}
+
+const char* activationName(Activation activation) {
+    switch (activation) {
+        case Activation::TANH: return "tanh";
+        case Activation::LINEAR: return "linear";
+        default: return "relu";
+    }
+}
+
+} // namespace
+
+NeuralNetwork::Architecture NeuralNetwork::Architecture::parse(const std::string& spec) {
+    std::vector<std::string> tokens;
+    size_t begin = 0;
+    while (begin <= spec.size()) {
+        size_t end = spec.find('-', begin);
+        if (end == std::string::npos) {
+            end = spec.size();
+        }
+        tokens.push_back(spec.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    if (tokens.size() < 2) {
+        throw std::invalid_argument("Architecture needs input and output sizes: " + spec);
+    }
+    
+    auto parseSize = [&spec](const std::string& token) {
+        size_t used = 0;
+        int size = 0;
+        try {
+            size = std::stoi(token, &used);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Bad layer size in architecture: " + spec);
+        }
+        return std::make_pair(size, token.substr(used));
+    };
+    
+    Architecture architecture;
+    architecture.hidden_sizes.clear();
+    auto input = parseSize(tokens.front());
+    if (input.first <= 0 || !input.second.empty()) {
+        throw std::invalid_argument("Architecture must start with a positive input size: " + spec);
+    }
+    architecture.input_size = input.first;
+    
+    auto output = parseSize(tokens.back());
+    if (output.first != OUTPUT_SIZE) {
+        throw std::invalid_argument("Architecture must end with the output size 5: " + spec);
+    }
+    if (output.second == ":dueling") {
+        architecture.head.type = HeadType::DUELING;
+    } else if (output.second == ":c51") {
+        architecture.head.type = HeadType::DISTRIBUTIONAL;
+    } else if (!output.second.empty() && output.second != ":linear") {
+        throw std::invalid_argument("Unknown output head in architecture: " + spec);
+    }
+    
+    for (size_t i = 1; i + 1 < tokens.size(); ++i) {
+        auto layer = parseSize(tokens[i]);
+        Activation activation = Activation::RELU;
+        if (layer.second == ":tanh") {
+            activation = Activation::TANH;
+        } else if (layer.second == ":linear") {
+            activation = Activation::LINEAR;
+        } else if (!layer.second.empty() && layer.second != ":relu") {
+            throw std::invalid_argument("Unknown activation in architecture: " + spec);
+        }
+        architecture.hidden_sizes.push_back(layer.first);
+        architecture.activations.push_back(activation);
+    }
+    return architecture;
+}
+
+std::string NeuralNetwork::Architecture::toString() const {
+    std::string spec = std::to_string(input_size);
+    for (size_t i = 0; i < hidden_sizes.size(); ++i) {
+        spec += "-" + std::to_string(hidden_sizes[i]);
+        if (i < activations.size() && activations[i] != Activation::RELU) {
+            spec += std::string(":") + activationName(activations[i]);
+        }
+    }
+    spec += "-" + std::to_string(OUTPUT_SIZE);
+    if (head.type == HeadType::DUELING) {
+        spec += ":dueling";
+    } else if (head.type == HeadType::DISTRIBUTIONAL) {
+        spec += ":c51";
+    }
+    return spec;
+}
+
+void NeuralNetwork::applyActivation(Eigen::Ref<Eigen::MatrixXd> values, Activation activation) {
+    activate(values, activation);
+}
+
+NeuralNetwork::NeuralNetwork(double learning_rate, const HeadConfig& head) 
+    : NeuralNetwork(trunkArchitecture({64, 32, 16}, head), learning_rate) {
+}
+
+NeuralNetwork::NeuralNetwork(const std::vector<int>& hidden_sizes, double learning_rate,
+                             const HeadConfig& head)
+    : NeuralNetwork(trunkArchitecture(hidden_sizes, head), learning_rate) {
+}
+
+NeuralNetwork::NeuralNetwork(const Architecture& architecture, double learning_rate)
+    : NeuralNetwork(architecture, learning_rate, std::random_device{}()) {
+}
+
+NeuralNetwork::NeuralNetwork(const Architecture& architecture, double learning_rate, uint64_t seed)
+    : input_size_(architecture.input_size), sparse_density_threshold_(0.0), head_config_(architecture.head),
+      fixed_kernel_(nullptr), fixed_kernels_enabled_(true), learning_rate_(learning_rate) {
+    if (input_size_ <= 0 || input_size_ > MAX_LAYER_SIZE) {
+        throw std::invalid_argument("Input size must be positive");
+    }
+    for (int size : architecture.hidden_sizes) {
+        if (size <= 0 || size > MAX_LAYER_SIZE) {
+            throw std::invalid_argument("Hidden layer sizes must be positive");
+        }
+    }
+    if (!architecture.activations.empty() &&
+        architecture.activations.size() != architecture.hidden_sizes.size()) {
+        throw std::invalid_argument("Need one activation per hidden layer");
+    }
+    hidden_activations_ = architecture.activations.empty()
+        ? std::vector<Activation>(architecture.hidden_sizes.size(), Activation::RELU)
+        : architecture.activations;
+    
+    initializeWeights(architecture.hidden_sizes, seed);
     initializeLayerInfo();
+    updateSparseLayers();
 }
 
-void NeuralNetwork::initializeWeights() {
-    // Network architecture: 8 -> 64 -> 32 -> 16 -> 5
-    std::vector<int> layer_sizes = {INPUT_SIZE, 64, 32, 16, OUTPUT_SIZE};
+NeuralNetwork::NeuralNetwork(const NeuralNetwork& other)
+    : input_size_(other.input_size_), weights_(other.weights_), biases_(other.biases_),
+      hidden_activations_(other.hidden_activations_), masks_(other.masks_),
+      sparse_weights_(other.sparse_weights_),
+      sparse_density_threshold_(other.sparse_density_threshold_),
+      head_(other.head_->clone()), head_config_(other.head_config_),
+      layer_info_(other.layer_info_), fixed_kernel_(other.fixed_kernel_),
+      fixed_kernels_enabled_(other.fixed_kernels_enabled_),
+      learning_rate_(other.learning_rate_) {
+}
+
+NeuralNetwork& NeuralNetwork::operator=(const NeuralNetwork& other) {
+    if (this != &other) {
+        input_size_ = other.input_size_;
+        weights_ = other.weights_;
+        biases_ = other.biases_;
+        hidden_activations_ = other.hidden_activations_;
+        masks_ = other.masks_;
+        sparse_weights_ = other.sparse_weights_;
+        sparse_density_threshold_ = other.sparse_density_threshold_;
+        head_ = other.head_->clone();
+        head_config_ = other.head_config_;
+        layer_info_ = other.layer_info_;
+        fixed_kernel_ = other.fixed_kernel_;
+        fixed_kernels_enabled_ = other.fixed_kernels_enabled_;
+        learning_rate_ = other.learning_rate_;
+    }
+    return *this;
+}
+
+void NeuralNetwork::initializeWeights(const std::vector<int>& hidden_sizes, uint64_t seed) {
+    // Network architecture: input -> hidden... -> head(5)
+    std::vector<int> layer_sizes = {input_size_};
+    layer_sizes.insert(layer_sizes.end(), hidden_sizes.begin(), hidden_sizes.end());
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::seed_seq seed_sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+    std::mt19937 gen(seed_sequence);
     
-    // Initialize weights and biases for each layer
+    // Initialize weights and biases for each hidden layer
     for (size_t i = 0; i < layer_sizes.size() - 1; ++i) {
         int input_size = layer_sizes[i];
         int output_size = layer_sizes[i + 1];
@@ -39,23 +250,20 @@ void NeuralNetwork::initializeWeights() {
         // Initialize biases to small positive values
         Eigen::VectorXd bias = Eigen::VectorXd::Constant(output_size, 0.01);
         biases_.push_back(bias);
-        
-        // Initialize activation storage
-        activations_.push_back(Eigen::VectorXd::Zero(output_size));
     }
     
-    // Add input layer activations
-    activations_.insert(activations_.begin(), Eigen::VectorXd::Zero(INPUT_SIZE));
+    head_ = makeOutputHead(head_config_, layer_sizes.back(), OUTPUT_SIZE, gen);
 }
 
 void NeuralNetwork::initializeLayerInfo() {
-    layer_info_ = {
-        {INPUT_SIZE, "Input", "#4CAF50"},
-        {64, "Hidden1", "#2196F3"},
-        {32, "Hidden2", "#FF9800"},
-        {16, "Hidden3", "#9C27B0"},
-        {OUTPUT_SIZE, "Output", "#F44336"}
-    };
+    static const char* const HIDDEN_COLORS[] = {"#2196F3", "#FF9800", "#9C27B0"};
+    
+    layer_info_ = {{input_size_, "Input", "#4CAF50"}};
+    for (size_t i = 0; i < weights_.size(); ++i) {
+        layer_info_.push_back({static_cast<int>(weights_[i].rows()),
+                               "Hidden" + std::to_string(i + 1), HIDDEN_COLORS[i % 3]});
+    }
+    layer_info_.push_back({OUTPUT_SIZE, "Output", "#F44336"});
 }
 
 double NeuralNetwork::relu(double x) {
@@ -66,98 +274,254 @@ double NeuralNetwork::sigmoid(double x) {
     return 1.0 / (1.0 + std::exp(-x));
 }
 
-Eigen::VectorXd NeuralNetwork::softmax(const Eigen::VectorXd& x) {
-    Eigen::VectorXd exp_x = x.array().exp();
-    return exp_x / exp_x.sum();
-}
-
-Eigen::VectorXd NeuralNetwork::forward(const Eigen::VectorXd& input) {
-    if (input.size() != INPUT_SIZE) {
+Eigen::VectorXd NeuralNetwork::forward(const Eigen::VectorXd& input,
+                                       std::vector<Eigen::VectorXd>* activations) const {
+    if (input.size() != input_size_) {
         throw std::invalid_argument("Input size mismatch");
     }
     
-    // Store input activations
-    activations_[0] = input;
+    // Common topologies run through a kernel compiled for their exact sizes
+    if (fixed_kernel_ && !activations) {
+        return head_->forward(fixed_kernel_(weights_.data(), biases_.data(), input));
+    }
+    
+    if (activations) {
+        activations->clear();
+        activations->reserve(weights_.size() + 2);
+        activations->push_back(input);
+    }
     Eigen::VectorXd current = input;
     
     // Forward propagation through hidden layers
-    for (size_t i = 0; i < weights_.size() - 1; ++i) {
-        current = weights_[i] * current + biases_[i];
-        
-        // Apply ReLU activation to hidden layers
-        for (int j = 0; j < current.size(); ++j) {
-            current(j) = relu(current(j));
+    for (size_t i = 0; i < weights_.size(); ++i) {
+        if (sparse_weights_[i].size() > 0) {
+            current = sparse_weights_[i] * current + biases_[i];
+        } else {
+            current = weights_[i] * current + biases_[i];
+        }
+        activate(current, hidden_activations_[i]);
+        if (activations) {
+            activations->push_back(current);
         }
-        
-        activations_[i + 1] = current;
     }
     
-    // Output layer with softmax
-    size_t output_layer = weights_.size() - 1;
-    current = weights_[output_layer] * current + biases_[output_layer];
-    current = softmax(current);
-    
-    activations_[output_layer + 1] = current;
+    // Output head produces action values
+    current = head_->forward(current);
+    if (activations) {
+        activations->push_back(current);
+    }
     return current;
 }
 
 void NeuralNetwork::backward(const Eigen::VectorXd& input, const Eigen::VectorXd& target) {
-    // Forward pass to get current activations
-    Eigen::VectorXd output = forward(input);
-    
-    // Compute gradients using backpropagation
-    std::vector<Eigen::VectorXd> deltas(weights_.size());
-    
-    // Output layer error
-    deltas[weights_.size() - 1] = output - target;
+    fitQValues(input, target);
+}
+
+void NeuralNetwork::forwardTrunk(const Eigen::MatrixXd& inputs,
+                                 std::vector<Eigen::MatrixXd>& layer_outputs) const {
+    layer_outputs.resize(weights_.size() + 1);
+    layer_outputs[0] = inputs;
+    for (size_t i = 0; i < weights_.size(); ++i) {
+        layer_outputs[i + 1] = (weights_[i] * layer_outputs[i]).colwise() + biases_[i];
+        activate(layer_outputs[i + 1], hidden_activations_[i]);
+    }
+}
+
+void NeuralNetwork::backpropagateTrunk(const std::vector<Eigen::MatrixXd>& layer_outputs,
+                                       Eigen::MatrixXd delta, Eigen::MatrixXd* input_gradient) {
+    // delta arrives as dLoss/d(last hidden output); gradients are summed over
+    // the batch so one call matches per-sample updates to first order
+    for (int i = static_cast<int>(weights_.size()) - 1; i >= 0; --i) {
+        activationBackward(delta, layer_outputs[i + 1], hidden_activations_[i]);
+        Eigen::MatrixXd prev_delta;
+        if (i > 0 || input_gradient) {
+            prev_delta = weights_[i].transpose() * delta;
+        }
+        weights_[i].noalias() -= learning_rate_ * (delta * layer_outputs[i].transpose());
+        biases_[i] -= learning_rate_ * delta.rowwise().sum();
+        if (!masks_.empty()) {
+            weights_[i].array() *= masks_[i].array();
+        }
+        delta = std::move(prev_delta);
+    }
+    if (input_gradient) {
+        *input_gradient = std::move(delta);
+    }
+    if (sparse_density_threshold_ > 0.0) {
+        updateSparseLayers();
+    }
+}
+
+void NeuralNetwork::pruneByMagnitude(double sparsity) {
+    if (sparsity < 0.0 || sparsity >= 1.0) {
+        throw std::invalid_argument("Sparsity must be in [0, 1)");
+    }
     
-    // Backpropagate errors
-    for (int i = static_cast<int>(weights_.size()) - 2; i >= 0; --i) {
-        Eigen::VectorXd error = weights_[i + 1].transpose() * deltas[i + 1];
+    masks_.resize(weights_.size());
+    std::vector<Eigen::Index> order;
+    for (size_t i = 0; i < weights_.size(); ++i) {
+        Eigen::MatrixXd& weight = weights_[i];
+        Eigen::Index size = weight.size();
+        Eigen::Index pruned = static_cast<Eigen::Index>(sparsity * static_cast<double>(size));
         
-        // Apply ReLU derivative
-        for (int j = 0; j < error.size(); ++j) {
-            error(j) *= (activations_[i + 1](j) > 0) ? 1.0 : 0.0;
-        }
+        // Already-pruned weights are zero, so they stay among the smallest
+        order.resize(size);
+        std::iota(order.begin(), order.end(), Eigen::Index(0));
+        std::nth_element(order.begin(), order.begin() + pruned, order.end(),
+                         [&weight](Eigen::Index a, Eigen::Index b) {
+                             return std::abs(weight(a)) < std::abs(weight(b));
+                         });
         
-        deltas[i] = error;
+        masks_[i] = Eigen::MatrixXd::Ones(weight.rows(), weight.cols());
+        for (Eigen::Index j = 0; j < pruned; ++j) {
+            masks_[i](order[j]) = 0.0;
+        }
+        weight.array() *= masks_[i].array();
+    }
+    updateSparseLayers();
+}
+
+void NeuralNetwork::clearPruningMasks() {
+    masks_.clear();
+}
+
+double NeuralNetwork::getLayerDensity(int layer) const {
+    if (layer < 0 || layer >= static_cast<int>(weights_.size())) {
+        throw std::out_of_range("Hidden layer index out of range");
+    }
+    const Eigen::MatrixXd& weight = weights_[layer];
+    return static_cast<double>((weight.array() != 0.0).count()) / static_cast<double>(weight.size());
+}
+
+void NeuralNetwork::setSparseInference(double density_threshold) {
+    sparse_density_threshold_ = std::max(0.0, density_threshold);
+    updateSparseLayers();
+}
+
+bool NeuralNetwork::isLayerSparse(int layer) const {
+    return layer >= 0 && layer < static_cast<int>(sparse_weights_.size()) &&
+           sparse_weights_[layer].size() > 0;
+}
+
+void NeuralNetwork::updateSparseLayers() {
+    sparse_weights_.resize(weights_.size());
+    for (size_t i = 0; i < weights_.size(); ++i) {
+        if (sparse_density_threshold_ > 0.0 &&
+            getLayerDensity(static_cast<int>(i)) <= sparse_density_threshold_) {
+            sparse_weights_[i] = weights_[i].sparseView();
+            sparse_weights_[i].makeCompressed();
+        } else {
+            sparse_weights_[i].resize(0, 0);
+        }
+    }
+    selectFixedKernel();
+}
+
+void NeuralNetwork::selectFixedKernel() {
+    fixed_kernel_ = nullptr;
+    if (!fixed_kernels_enabled_) {
+        return;
+    }
+    std::vector<int> hidden_sizes;
+    for (size_t i = 0; i < weights_.size(); ++i) {
+        if (hidden_activations_[i] != Activation::RELU || sparse_weights_[i].size() > 0) {
+            return;
+        }
+        hidden_sizes.push_back(static_cast<int>(weights_[i].rows()));
+    }
+    fixed_kernel_ = findFixedTrunkKernel(input_size_, hidden_sizes);
+}
+
+void NeuralNetwork::setFixedSizeKernels(bool enabled) {
+    fixed_kernels_enabled_ = enabled;
+    selectFixedKernel();
+}
+
+NeuralNetwork::Architecture NeuralNetwork::getArchitecture() const {
+    Architecture architecture;
+    architecture.input_size = input_size_;
+    architecture.hidden_sizes.clear();
+    for (const auto& weight : weights_) {
+        architecture.hidden_sizes.push_back(static_cast<int>(weight.rows()));
+    }
+    architecture.activations = hidden_activations_;
+    architecture.head = head_config_;
+    return architecture;
+}
+
+Eigen::MatrixXd NeuralNetwork::forwardFeatures(const Eigen::MatrixXd& inputs) const {
+    if (inputs.rows() != input_size_) {
+        throw std::invalid_argument("Input size mismatch");
     }
     
-    // Update weights and biases
+    Eigen::MatrixXd current = inputs;
     for (size_t i = 0; i < weights_.size(); ++i) {
-        Eigen::VectorXd prev_activation = (i == 0) ? input : activations_[i];
-        
-        weights_[i] -= learning_rate_ * (deltas[i] * prev_activation.transpose());
-        biases_[i] -= learning_rate_ * deltas[i];
+        current = (weights_[i] * current).colwise() + biases_[i];
+        activate(current, hidden_activations_[i]);
     }
+    return current;
 }
 
-std::vector<double> NeuralNetwork::getActivations(int layer) const {
-    if (layer < 0 || layer >= static_cast<int>(activations_.size())) {
-        return {};
+Eigen::MatrixXd NeuralNetwork::forwardBatch(const Eigen::MatrixXd& inputs, unsigned num_threads) const {
+    if (inputs.rows() != input_size_) {
+        throw std::invalid_argument("Input size mismatch");
     }
     
-    const Eigen::VectorXd& activations = activations_[layer];
-    std::vector<double> result(activations.size());
+    Eigen::MatrixXd outputs(head_->numActions(), inputs.cols());
+    parallelFor(static_cast<size_t>(inputs.cols()), num_threads, [&](size_t begin, size_t end) {
+        outputs.middleCols(begin, end - begin) =
+            head_->forward(forwardFeatures(inputs.middleCols(begin, end - begin)));
+    }, 256);
     
-    for (int i = 0; i < activations.size(); ++i) {
-        result[i] = activations(i);
+    return outputs;
+}
+
+Eigen::MatrixXd NeuralNetwork::bellmanTargets(const Eigen::MatrixXd& next_inputs,
+                                              const std::vector<int>& next_actions,
+                                              const Eigen::VectorXd& rewards,
+                                              const Eigen::VectorXd& discounts) const {
+    return head_->bellmanTargets(forwardFeatures(next_inputs), next_actions, rewards, discounts);
+}
+
+double NeuralNetwork::trainBatch(const Eigen::MatrixXd& inputs,
+                                 const std::vector<int>& actions,
+                                 const Eigen::MatrixXd& targets,
+                                 Eigen::MatrixXd* input_gradient) {
+    if (inputs.rows() != input_size_ || static_cast<size_t>(inputs.cols()) != actions.size() ||
+        inputs.cols() != targets.cols()) {
+        throw std::invalid_argument("Batch shape mismatch");
     }
     
-    return result;
+    std::vector<Eigen::MatrixXd> layer_outputs;
+    forwardTrunk(inputs, layer_outputs);
+    
+    double loss = 0.0;
+    Eigen::MatrixXd delta = head_->backwardTD(layer_outputs.back(), actions, targets,
+                                              learning_rate_, loss);
+    backpropagateTrunk(layer_outputs, std::move(delta), input_gradient);
+    return loss;
 }
 
-double NeuralNetwork::calculateLoss(const Eigen::VectorXd& predicted, const Eigen::VectorXd& target) const {
-    // Cross-entropy loss
-    double loss = 0.0;
-    for (int i = 0; i < predicted.size(); ++i) {
-        if (target(i) > 0) {
-            loss -= target(i) * std::log(std::max(predicted(i), 1e-15));
-        }
+double NeuralNetwork::fitQValues(const Eigen::MatrixXd& inputs, const Eigen::MatrixXd& q_targets) {
+    if (inputs.rows() != input_size_ || inputs.cols() != q_targets.cols() ||
+        q_targets.rows() != head_->numActions()) {
+        throw std::invalid_argument("Batch shape mismatch");
     }
+    
+    std::vector<Eigen::MatrixXd> layer_outputs;
+    forwardTrunk(inputs, layer_outputs);
+    
+    double loss = 0.0;
+    Eigen::MatrixXd delta = head_->backwardQ(layer_outputs.back(), q_targets, learning_rate_, loss);
+    backpropagateTrunk(layer_outputs, std::move(delta));
     return loss;
 }
 
+double NeuralNetwork::calculateLoss(const Eigen::VectorXd& predicted, const Eigen::VectorXd& target) const {
+    // Squared error on Q-values
+    return 0.5 * (predicted - target).squaredNorm();
+}
+
 void NeuralNetwork::updateWeights(const std::vector<Eigen::VectorXd>& inputs,
                                  const std::vector<Eigen::VectorXd>& targets) {
     for (size_t i = 0; i < inputs.size(); ++i) {
@@ -171,6 +535,25 @@ void NeuralNetwork::saveWeights(const std::string& filename) const {
         throw std::runtime_error("Cannot open file for writing: " + filename);
     }
     
+    // Format header and output head configuration
+    file.write(reinterpret_cast<const char*>(&MODEL_MAGIC), sizeof(MODEL_MAGIC));
+    file.write(reinterpret_cast<const char*>(&MODEL_VERSION), sizeof(MODEL_VERSION));
+    int head_type = static_cast<int>(head_config_.type);
+    file.write(reinterpret_cast<const char*>(&head_type), sizeof(head_type));
+    file.write(reinterpret_cast<const char*>(&head_config_.atoms), sizeof(head_config_.atoms));
+    file.write(reinterpret_cast<const char*>(&head_config_.v_min), sizeof(head_config_.v_min));
+    file.write(reinterpret_cast<const char*>(&head_config_.v_max), sizeof(head_config_.v_max));
+    
+    // Architecture descriptor: hidden layer sizes and activations
+    uint32_t num_hidden = static_cast<uint32_t>(weights_.size());
+    file.write(reinterpret_cast<const char*>(&num_hidden), sizeof(num_hidden));
+    for (size_t i = 0; i < weights_.size(); ++i) {
+        int32_t size = static_cast<int32_t>(weights_[i].rows());
+        int32_t activation = static_cast<int32_t>(hidden_activations_[i]);
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(&activation), sizeof(activation));
+    }
+    
     // Save architecture info
     size_t num_layers = weights_.size();
     file.write(reinterpret_cast<const char*>(&num_layers), sizeof(num_layers));
@@ -190,6 +573,8 @@ void NeuralNetwork::saveWeights(const std::string& filename) const {
         file.write(reinterpret_cast<const char*>(biases_[i].data()), 
                   bias_size * sizeof(double));
     }
+    
+    head_->save(file);
 }
 
 void NeuralNetwork::loadWeights(const std::string& filename) {
@@ -198,35 +583,135 @@ void NeuralNetwork::loadWeights(const std::string& filename) {
         throw std::runtime_error("Cannot open file for reading: " + filename);
     }
     
-    size_t num_layers;
+    uint32_t magic = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    bool legacy = magic != MODEL_MAGIC;
+    
+    HeadConfig head_config;
+    std::vector<int> descriptor_sizes;
+    std::vector<Activation> activations;
+    bool has_descriptor = false;
+    if (legacy) {
+        file.seekg(0);
+    } else {
+        uint32_t version = 0;
+        int head_type = 0;
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (version != 1 && version != MODEL_VERSION) {
+            throw std::runtime_error("Unsupported model file version: " + filename);
+        }
+        file.read(reinterpret_cast<char*>(&head_type), sizeof(head_type));
+        file.read(reinterpret_cast<char*>(&head_config.atoms), sizeof(head_config.atoms));
+        file.read(reinterpret_cast<char*>(&head_config.v_min), sizeof(head_config.v_min));
+        file.read(reinterpret_cast<char*>(&head_config.v_max), sizeof(head_config.v_max));
+        head_config.type = static_cast<HeadType>(head_type);
+        if (!file || !validHeadConfig(head_config)) {
+            throw std::runtime_error("Invalid output head in model file: " + filename);
+        }
+        
+        has_descriptor = version >= 2;
+        if (has_descriptor) {
+            uint32_t num_hidden = 0;
+            file.read(reinterpret_cast<char*>(&num_hidden), sizeof(num_hidden));
+            for (uint32_t i = 0; i < num_hidden && file; ++i) {
+                int32_t size = 0;
+                int32_t activation = 0;
+                file.read(reinterpret_cast<char*>(&size), sizeof(size));
+                file.read(reinterpret_cast<char*>(&activation), sizeof(activation));
+                if (size <= 0 || size > MAX_LAYER_SIZE || !validActivation(activation)) {
+                    throw std::runtime_error("Invalid architecture descriptor in model file: " + filename);
+                }
+                descriptor_sizes.push_back(size);
+                activations.push_back(static_cast<Activation>(activation));
+            }
+        }
+    }
+    
+    size_t num_layers = 0;
     file.read(reinterpret_cast<char*>(&num_layers), sizeof(num_layers));
+    if (has_descriptor && num_layers != descriptor_sizes.size()) {
+        throw std::runtime_error("Architecture descriptor does not match layers in model file: " + filename);
+    }
     
-    weights_.clear();
-    biases_.clear();
+    std::vector<Eigen::MatrixXd> weights;
+    std::vector<Eigen::VectorXd> biases;
     
-    for (size_t i = 0; i < num_layers; ++i) {
+    for (size_t i = 0; i < num_layers && file; ++i) {
         int rows, cols;
         file.read(reinterpret_cast<char*>(&rows), sizeof(rows));
         file.read(reinterpret_cast<char*>(&cols), sizeof(cols));
+        if (!file || rows <= 0 || cols <= 0 || rows > MAX_LAYER_SIZE || cols > MAX_LAYER_SIZE) {
+            throw std::runtime_error("Invalid layer shape in model file: " + filename);
+        }
         
         Eigen::MatrixXd weight(rows, cols);
         file.read(reinterpret_cast<char*>(weight.data()), rows * cols * sizeof(double));
-        weights_.push_back(weight);
+        weights.push_back(weight);
         
         int bias_size;
         file.read(reinterpret_cast<char*>(&bias_size), sizeof(bias_size));
         
+        if (!file || bias_size != rows) {
+            throw std::runtime_error("Invalid bias size in model file: " + filename);
+        }
+        
         Eigen::VectorXd bias(bias_size);
         file.read(reinterpret_cast<char*>(bias.data()), bias_size * sizeof(double));
-        biases_.push_back(bias);
+        biases.push_back(bias);
+    }
+    if (!file) {
+        throw std::runtime_error("Truncated model file: " + filename);
     }
     
-    // Reinitialize activations
-    activations_.clear();
-    activations_.push_back(Eigen::VectorXd::Zero(INPUT_SIZE));
-    for (const auto& weight : weights_) {
-        activations_.push_back(Eigen::VectorXd::Zero(weight.rows()));
+    std::unique_ptr<OutputHead> head;
+    if (legacy) {
+        // The last dense layer was the (softmax) output layer; keep its
+        // weights as a linear Q head
+        if (weights.empty()) {
+            throw std::runtime_error("Model file has no output layer: " + filename);
+        }
+        head = std::make_unique<LinearQHead>(weights.back(), biases.back());
+        weights.pop_back();
+        biases.pop_back();
+    } else {
+        int feature_size = weights.empty() ? INPUT_SIZE : static_cast<int>(weights.back().rows());
+        std::mt19937 gen(0);
+        head = makeOutputHead(head_config, feature_size, OUTPUT_SIZE, gen);
+        head->load(file);
+        if (!file) {
+            throw std::runtime_error("Truncated model file: " + filename);
+        }
+    }
+    
+    // Validate that the layers chain from the input to the head. The input
+    // width is taken from the first layer (state features only when the
+    // model has no hidden layers).
+    const int input_size = weights.empty() ? INPUT_SIZE : static_cast<int>(weights.front().cols());
+    int expected_cols = input_size;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        if (weights[i].cols() != expected_cols || biases[i].size() != weights[i].rows() ||
+            (has_descriptor && weights[i].rows() != descriptor_sizes[i])) {
+            throw std::runtime_error("Inconsistent layer shapes in model file: " + filename);
+        }
+        expected_cols = static_cast<int>(weights[i].rows());
+    }
+    if (head->inputSize() != expected_cols || head->numActions() != OUTPUT_SIZE) {
+        throw std::runtime_error("Output layer shape mismatch in model file: " + filename);
     }
+    
+    input_size_ = input_size;
+    weights_ = std::move(weights);
+    biases_ = std::move(biases);
+    head_ = std::move(head);
+    head_config_ = head_config;
+    hidden_activations_ = has_descriptor ? std::move(activations)
+                                         : std::vector<Activation>(weights_.size(), Activation::RELU);
+    initializeLayerInfo();
+    
+    // Masks belong to the previous parameters; a pruned model file still
+    // carries its zeros, so sparse inference picks them up again
+    masks_.clear();
+    updateSparseLayers();
 }
 
 } // namespace MusicAI
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <string>
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include "output_heads.h"
+#include "fixed_trunk.h"
 
 namespace MusicAI {
 
@@ -16,31 +21,121 @@ public:
         std::string name;
         std::string color;
     };
+    
+    enum class Activation {
+        RELU = 0,
+        TANH = 1,
+        LINEAR = 2
+    };
+    
+    // Trunk topology plus output head, stored at the front of model files so
+    // a different topology can be rolled out without recompiling
+    struct Architecture {
+        int input_size = INPUT_SIZE;          // State features plus any appended embeddings
+        std::vector<int> hidden_sizes = {64, 32, 16};
+        std::vector<Activation> activations;  // One per hidden layer; empty = all ReLU
+        HeadConfig head;
+        
+        // "8-128-64-32-5", optionally with per-layer activations ("8-64:tanh-32-5")
+        // and a wider input ("40-64-32-16-5")
+        static Architecture parse(const std::string& spec);
+        std::string toString() const;
+    };
+    
+    // Applies a hidden-layer activation in place (one sample per column)
+    static void applyActivation(Eigen::Ref<Eigen::MatrixXd> values, Activation activation);
 
 private:
-    std::vector<Eigen::MatrixXd> weights_;
+    int input_size_;
+    std::vector<Eigen::MatrixXd> weights_;      // Hidden layers
     std::vector<Eigen::VectorXd> biases_;
-    std::vector<Eigen::VectorXd> activations_;  // For visualization
+    std::vector<Activation> hidden_activations_;
+    std::vector<Eigen::MatrixXd> masks_;        // Pruning masks (1 = kept); empty when unpruned
+    std::vector<Eigen::SparseMatrix<double, Eigen::RowMajor>> sparse_weights_;  // 0x0 = layer runs dense
+    double sparse_density_threshold_;           // 0 = sparse inference off
+    std::unique_ptr<OutputHead> head_;          // Output layer producing Q-values
+    HeadConfig head_config_;
     std::vector<LayerInfo> layer_info_;
+    FixedTrunkKernel fixed_kernel_;             // Compile-time-sized trunk for forward(), if any
+    bool fixed_kernels_enabled_;
     
     double learning_rate_;
     
     // Activation functions
     static double relu(double x);
     static double sigmoid(double x);
-    static Eigen::VectorXd softmax(const Eigen::VectorXd& x);
     
 public:
-    NeuralNetwork(double learning_rate = 0.001);
+    // Default 8 -> 64 -> 32 -> 16 -> head trunk
+    NeuralNetwork(double learning_rate = 0.001, const HeadConfig& head = HeadConfig());
+    // Custom trunk: hidden ReLU layer widths between the input and the head
+    NeuralNetwork(const std::vector<int>& hidden_sizes, double learning_rate = 0.001,
+                  const HeadConfig& head = HeadConfig());
+    // Weights are drawn from `seed`; the overloads without one seed from std::random_device
+    explicit NeuralNetwork(const Architecture& architecture, double learning_rate = 0.001);
+    NeuralNetwork(const Architecture& architecture, double learning_rate, uint64_t seed);
+    NeuralNetwork(const NeuralNetwork& other);
+    NeuralNetwork& operator=(const NeuralNetwork& other);
     
-    // Core functionality
-    Eigen::VectorXd forward(const Eigen::VectorXd& input);
+    // Core functionality (Q-values of all actions). Layer outputs (input,
+    // each hidden layer, Q-values) are copied into `activations` only when
+    // the caller asks for them, e.g. for a sampled visualization capture.
+    Eigen::VectorXd forward(const Eigen::VectorXd& input,
+                            std::vector<Eigen::VectorXd>* activations = nullptr) const;
     void backward(const Eigen::VectorXd& input, const Eigen::VectorXd& target);
     
+    // Batched inference and minibatch training (one sample per column).
+    // forwardBatch is safe to call concurrently; column blocks are split
+    // across num_threads threads.
+    Eigen::MatrixXd forwardBatch(const Eigen::MatrixXd& inputs, unsigned num_threads = 1) const;
+    Eigen::MatrixXd forwardFeatures(const Eigen::MatrixXd& inputs) const;
+    
+    // TD training through the output head: targets come from
+    // bellmanTargets() on the target network. Returns the summed batch loss.
+    // input_gradient, if given, receives dLoss/dinputs (before the update)
+    // for features trained outside the network, e.g. embeddings.
+    Eigen::MatrixXd bellmanTargets(const Eigen::MatrixXd& next_inputs,
+                                   const std::vector<int>& next_actions,
+                                   const Eigen::VectorXd& rewards,
+                                   const Eigen::VectorXd& discounts) const;
+    double trainBatch(const Eigen::MatrixXd& inputs,
+                      const std::vector<int>& actions,
+                      const Eigen::MatrixXd& targets,
+                      Eigen::MatrixXd* input_gradient = nullptr);
+    
+    // Squared-error regression of all Q-values (gradients summed over the batch)
+    double fitQValues(const Eigen::MatrixXd& inputs, const Eigen::MatrixXd& q_targets);
+    
+    // Magnitude pruning of the hidden layers: zeroes the smallest weights of
+    // each layer until `sparsity` of it is pruned. Masks keep pruned weights
+    // at zero through later training; raising sparsity over successive
+    // calls gives iterative pruning.
+    void pruneByMagnitude(double sparsity);
+    void clearPruningMasks();
+    bool isPruned() const { return !masks_.empty(); }
+    double getLayerDensity(int layer) const;  // Non-zero fraction of hidden layer `layer`
+    
+    // Single-state forward() runs hidden layers whose density is at or below
+    // the threshold through compressed sparse kernels. Batched paths and
+    // training keep the dense weights, which win for batches at all but the
+    // most extreme densities in bench/sparse_bench. 0 turns sparse inference off.
+    void setSparseInference(double density_threshold);
+    bool isLayerSparse(int layer) const;
+    
+    // Topologies in fixedTrunkTopologies() with all-ReLU, dense layers run
+    // single-state forward() through a pre-instantiated fixed-size kernel
+    Architecture getArchitecture() const;
+    int getInputSize() const { return input_size_; }
+    void setFixedSizeKernels(bool enabled);
+    bool usesFixedSizeKernel() const { return fixed_kernel_ != nullptr; }
+    
     // For visualization and debugging
-    std::vector<double> getActivations(int layer) const;
     std::vector<LayerInfo> getLayerInfo() const { return layer_info_; }
-    int getLayerCount() const { return static_cast<int>(weights_.size()) + 1; }
+    int getLayerCount() const { return static_cast<int>(weights_.size()) + 2; }
+    const Eigen::MatrixXd& getLayerWeights(int layer) const { return weights_.at(layer); }
+    const Eigen::VectorXd& getLayerBias(int layer) const { return biases_.at(layer); }
+    const OutputHead& getHead() const { return *head_; }
+    const HeadConfig& getHeadConfig() const { return head_config_; }
     
     // Serialization
     void saveWeights(const std::string& filename) const;
@@ -52,8 +147,15 @@ public:
                       const std::vector<Eigen::VectorXd>& targets);
     
 private:
-    void initializeWeights();
+    void initializeWeights(const std::vector<int>& hidden_sizes, uint64_t seed);
     void initializeLayerInfo();
+    void updateSparseLayers();
+    void selectFixedKernel();
+    
+    // Hidden-layer forward pass keeping every layer's batch output
+    void forwardTrunk(const Eigen::MatrixXd& inputs, std::vector<Eigen::MatrixXd>& layer_outputs) const;
+    void backpropagateTrunk(const std::vector<Eigen::MatrixXd>& layer_outputs, Eigen::MatrixXd delta,
+                            Eigen::MatrixXd* input_gradient = nullptr);
 };
 
 } // namespace MusicAI
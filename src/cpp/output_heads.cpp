@@ -0,0 +1,362 @@
+#include "output_heads.h"
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+// Xavier initialization, as used for the hidden layers
+Eigen::MatrixXd xavierMatrix(int rows, int cols, std::mt19937& gen) {
+    std::normal_distribution<double> dist(0.0, std::sqrt(2.0 / (rows + cols)));
+    Eigen::MatrixXd matrix(rows, cols);
+    for (int col = 0; col < cols; ++col) {
+        for (int row = 0; row < rows; ++row) {
+            matrix(row, col) = dist(gen);
+        }
+    }
+    return matrix;
+}
+
+void writeMatrix(std::ostream& out, const Eigen::MatrixXd& matrix) {
+    int rows = static_cast<int>(matrix.rows());
+    int cols = static_cast<int>(matrix.cols());
+    out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
+    out.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
+    out.write(reinterpret_cast<const char*>(matrix.data()), rows * cols * sizeof(double));
+}
+
+// Reads a matrix written by writeMatrix into `matrix`, which must already
+// have the expected shape
+template <typename Derived>
+void readMatrix(std::istream& in, Eigen::PlainObjectBase<Derived>& matrix) {
+    int rows = 0, cols = 0;
+    in.read(reinterpret_cast<char*>(&rows), sizeof(rows));
+    in.read(reinterpret_cast<char*>(&cols), sizeof(cols));
+    if (!in || rows != matrix.rows() || cols != matrix.cols()) {
+        throw std::runtime_error("Output head parameter shape mismatch");
+    }
+    in.read(reinterpret_cast<char*>(matrix.data()), rows * cols * sizeof(double));
+    if (!in) {
+        throw std::runtime_error("Truncated output head parameters");
+    }
+}
+
+// Runs in the first initializer, before the atom-sized members are allocated
+int checkedAtoms(int atoms, double v_min, double v_max) {
+    if (!validHeadConfig({HeadType::DISTRIBUTIONAL, atoms, v_min, v_max})) {
+        throw std::invalid_argument("Distributional head needs 2-1024 atoms and a finite v_max > v_min");
+    }
+    return atoms;
+}
+
+} // namespace
+
+bool validHeadConfig(const HeadConfig& config) {
+    switch (config.type) {
+        case HeadType::LINEAR_Q:
+        case HeadType::DUELING:
+            return true;
+        case HeadType::DISTRIBUTIONAL:
+            return config.atoms >= 2 && config.atoms <= DistributionalHead::MAX_ATOMS &&
+                   std::isfinite(config.v_min) && std::isfinite(config.v_max) && config.v_max > config.v_min;
+    }
+    return false;
+}
+
+std::unique_ptr<OutputHead> makeOutputHead(const HeadConfig& config, int input_size,
+                                           int num_actions, std::mt19937& gen) {
+    switch (config.type) {
+        case HeadType::LINEAR_Q:
+            return std::make_unique<LinearQHead>(input_size, num_actions, gen);
+        case HeadType::DUELING:
+            return std::make_unique<DuelingHead>(input_size, num_actions, gen);
+        case HeadType::DISTRIBUTIONAL:
+            return std::make_unique<DistributionalHead>(input_size, num_actions, config.atoms,
+                                                        config.v_min, config.v_max, gen);
+    }
+    throw std::invalid_argument("Unknown output head type");
+}
+
+// ---------------------------------------------------------------------------
+// Linear Q head
+
+LinearQHead::LinearQHead(int input_size, int num_actions, std::mt19937& gen)
+    : weights_(xavierMatrix(num_actions, input_size, gen)),
+      bias_(Eigen::VectorXd::Constant(num_actions, 0.01)) {
+}
+
+LinearQHead::LinearQHead(const Eigen::MatrixXd& weights, const Eigen::VectorXd& bias)
+    : weights_(weights), bias_(bias) {
+}
+
+std::unique_ptr<OutputHead> LinearQHead::clone() const {
+    return std::make_unique<LinearQHead>(*this);
+}
+
+Eigen::MatrixXd LinearQHead::forward(const Eigen::MatrixXd& features) const {
+    return (weights_ * features).colwise() + bias_;
+}
+
+Eigen::MatrixXd LinearQHead::bellmanTargets(const Eigen::MatrixXd& next_features,
+                                            const std::vector<int>& next_actions,
+                                            const Eigen::VectorXd& rewards,
+                                            const Eigen::VectorXd& discounts) const {
+    Eigen::MatrixXd next_q = forward(next_features);
+    Eigen::MatrixXd targets(1, next_features.cols());
+    for (Eigen::Index j = 0; j < targets.cols(); ++j) {
+        targets(0, j) = rewards(j) + discounts(j) * next_q(next_actions[j], j);
+    }
+    return targets;
+}
+
+Eigen::MatrixXd LinearQHead::backwardTD(const Eigen::MatrixXd& features,
+                                        const std::vector<int>& actions,
+                                        const Eigen::MatrixXd& targets,
+                                        double learning_rate, double& loss) {
+    Eigen::MatrixXd q = forward(features);
+    Eigen::MatrixXd dq = Eigen::MatrixXd::Zero(q.rows(), q.cols());
+    for (Eigen::Index j = 0; j < q.cols(); ++j) {
+        dq(actions[j], j) = q(actions[j], j) - targets(0, j);
+    }
+    loss = 0.5 * dq.squaredNorm();
+    return applyQGradient(features, dq, learning_rate);
+}
+
+Eigen::MatrixXd LinearQHead::backwardQ(const Eigen::MatrixXd& features,
+                                       const Eigen::MatrixXd& q_targets,
+                                       double learning_rate, double& loss) {
+    Eigen::MatrixXd dq = forward(features) - q_targets;
+    loss = 0.5 * dq.squaredNorm();
+    return applyQGradient(features, dq, learning_rate);
+}
+
+Eigen::MatrixXd LinearQHead::applyQGradient(const Eigen::MatrixXd& features,
+                                            const Eigen::MatrixXd& dq, double learning_rate) {
+    Eigen::MatrixXd feature_grad = weights_.transpose() * dq;
+    weights_.noalias() -= learning_rate * (dq * features.transpose());
+    bias_ -= learning_rate * dq.rowwise().sum();
+    return feature_grad;
+}
+
+void LinearQHead::save(std::ostream& out) const {
+    writeMatrix(out, weights_);
+    writeMatrix(out, bias_);
+}
+
+void LinearQHead::load(std::istream& in) {
+    readMatrix(in, weights_);
+    readMatrix(in, bias_);
+}
+
+// ---------------------------------------------------------------------------
+// Dueling head
+
+DuelingHead::DuelingHead(int input_size, int num_actions, std::mt19937& gen)
+    : value_weights_(xavierMatrix(1, input_size, gen)),
+      value_bias_(0.01),
+      advantage_weights_(xavierMatrix(num_actions, input_size, gen)),
+      advantage_bias_(Eigen::VectorXd::Constant(num_actions, 0.01)) {
+}
+
+std::unique_ptr<OutputHead> DuelingHead::clone() const {
+    return std::make_unique<DuelingHead>(*this);
+}
+
+Eigen::MatrixXd DuelingHead::forward(const Eigen::MatrixXd& features) const {
+    Eigen::RowVectorXd value = (value_weights_ * features).array() + value_bias_;
+    Eigen::MatrixXd advantage = (advantage_weights_ * features).colwise() + advantage_bias_;
+    Eigen::RowVectorXd mean_advantage = advantage.colwise().mean();
+    advantage.rowwise() += value - mean_advantage;
+    return advantage;
+}
+
+Eigen::MatrixXd DuelingHead::bellmanTargets(const Eigen::MatrixXd& next_features,
+                                            const std::vector<int>& next_actions,
+                                            const Eigen::VectorXd& rewards,
+                                            const Eigen::VectorXd& discounts) const {
+    Eigen::MatrixXd next_q = forward(next_features);
+    Eigen::MatrixXd targets(1, next_features.cols());
+    for (Eigen::Index j = 0; j < targets.cols(); ++j) {
+        targets(0, j) = rewards(j) + discounts(j) * next_q(next_actions[j], j);
+    }
+    return targets;
+}
+
+Eigen::MatrixXd DuelingHead::backwardTD(const Eigen::MatrixXd& features,
+                                        const std::vector<int>& actions,
+                                        const Eigen::MatrixXd& targets,
+                                        double learning_rate, double& loss) {
+    Eigen::MatrixXd q = forward(features);
+    Eigen::MatrixXd dq = Eigen::MatrixXd::Zero(q.rows(), q.cols());
+    for (Eigen::Index j = 0; j < q.cols(); ++j) {
+        dq(actions[j], j) = q(actions[j], j) - targets(0, j);
+    }
+    loss = 0.5 * dq.squaredNorm();
+    return applyQGradient(features, dq, learning_rate);
+}
+
+Eigen::MatrixXd DuelingHead::backwardQ(const Eigen::MatrixXd& features,
+                                       const Eigen::MatrixXd& q_targets,
+                                       double learning_rate, double& loss) {
+    Eigen::MatrixXd dq = forward(features) - q_targets;
+    loss = 0.5 * dq.squaredNorm();
+    return applyQGradient(features, dq, learning_rate);
+}
+
+Eigen::MatrixXd DuelingHead::applyQGradient(const Eigen::MatrixXd& features,
+                                            const Eigen::MatrixXd& dq, double learning_rate) {
+    // Q = V + A - mean(A): every action's error flows into V, and A receives
+    // the error minus its mean over actions
+    Eigen::RowVectorXd dvalue = dq.colwise().sum();
+    Eigen::MatrixXd dadvantage = dq.rowwise() - dq.colwise().mean();
+    
+    Eigen::MatrixXd feature_grad = value_weights_.transpose() * dvalue +
+                                   advantage_weights_.transpose() * dadvantage;
+    value_weights_.noalias() -= learning_rate * (dvalue * features.transpose());
+    value_bias_ -= learning_rate * dvalue.sum();
+    advantage_weights_.noalias() -= learning_rate * (dadvantage * features.transpose());
+    advantage_bias_ -= learning_rate * dadvantage.rowwise().sum();
+    return feature_grad;
+}
+
+void DuelingHead::save(std::ostream& out) const {
+    writeMatrix(out, value_weights_);
+    writeMatrix(out, Eigen::MatrixXd::Constant(1, 1, value_bias_));
+    writeMatrix(out, advantage_weights_);
+    writeMatrix(out, advantage_bias_);
+}
+
+void DuelingHead::load(std::istream& in) {
+    Eigen::MatrixXd value_bias(1, 1);
+    readMatrix(in, value_weights_);
+    readMatrix(in, value_bias);
+    readMatrix(in, advantage_weights_);
+    readMatrix(in, advantage_bias_);
+    value_bias_ = value_bias(0, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Distributional (C51) head
+
+DistributionalHead::DistributionalHead(int input_size, int num_actions, int atoms,
+                                       double v_min, double v_max, std::mt19937& gen)
+    : num_actions_(num_actions), atoms_(checkedAtoms(atoms, v_min, v_max)), v_min_(v_min), v_max_(v_max),
+      support_(Eigen::VectorXd::LinSpaced(atoms, v_min, v_max)),
+      weights_(xavierMatrix(num_actions * atoms, input_size, gen)),
+      bias_(Eigen::VectorXd::Zero(num_actions * atoms)) {
+}
+
+std::unique_ptr<OutputHead> DistributionalHead::clone() const {
+    return std::make_unique<DistributionalHead>(*this);
+}
+
+Eigen::MatrixXd DistributionalHead::distributions(const Eigen::MatrixXd& features) const {
+    Eigen::MatrixXd probs = (weights_ * features).colwise() + bias_;
+    for (int a = 0; a < num_actions_; ++a) {
+        auto block = probs.middleRows(a * atoms_, atoms_);
+        Eigen::RowVectorXd max_logit = block.colwise().maxCoeff();
+        block = (block.rowwise() - max_logit).array().exp().matrix();
+        block.array().rowwise() /= block.colwise().sum().array();
+    }
+    return probs;
+}
+
+Eigen::MatrixXd DistributionalHead::forward(const Eigen::MatrixXd& features) const {
+    Eigen::MatrixXd probs = distributions(features);
+    Eigen::MatrixXd q(num_actions_, features.cols());
+    for (int a = 0; a < num_actions_; ++a) {
+        q.row(a) = support_.transpose() * probs.middleRows(a * atoms_, atoms_);
+    }
+    return q;
+}
+
+Eigen::MatrixXd DistributionalHead::bellmanTargets(const Eigen::MatrixXd& next_features,
+                                                   const std::vector<int>& next_actions,
+                                                   const Eigen::VectorXd& rewards,
+                                                   const Eigen::VectorXd& discounts) const {
+    // Project r + discount * z onto the fixed support (Bellemare et al., 2017)
+    Eigen::MatrixXd next_probs = distributions(next_features);
+    Eigen::MatrixXd targets = Eigen::MatrixXd::Zero(atoms_, next_features.cols());
+    double delta_z = (v_max_ - v_min_) / (atoms_ - 1);
+    
+    for (Eigen::Index j = 0; j < targets.cols(); ++j) {
+        auto p = next_probs.col(j).segment(next_actions[j] * atoms_, atoms_);
+        for (int i = 0; i < atoms_; ++i) {
+            double tz = std::min(v_max_, std::max(v_min_, rewards(j) + discounts(j) * support_(i)));
+            // Rounding can push b just past the last atom when tz == v_max
+            double b = std::min(static_cast<double>(atoms_ - 1), (tz - v_min_) / delta_z);
+            int lower = static_cast<int>(std::floor(b));
+            int upper = static_cast<int>(std::ceil(b));
+            if (lower == upper) {
+                targets(lower, j) += p(i);
+            } else {
+                targets(lower, j) += p(i) * (upper - b);
+                targets(upper, j) += p(i) * (b - lower);
+            }
+        }
+    }
+    return targets;
+}
+
+Eigen::MatrixXd DistributionalHead::backwardTD(const Eigen::MatrixXd& features,
+                                               const std::vector<int>& actions,
+                                               const Eigen::MatrixXd& targets,
+                                               double learning_rate, double& loss) {
+    // Cross-entropy between the projected target and the taken action's
+    // distribution; its logit gradient is p - m
+    Eigen::MatrixXd probs = distributions(features);
+    Eigen::MatrixXd dlogits = Eigen::MatrixXd::Zero(probs.rows(), probs.cols());
+    loss = 0.0;
+    for (Eigen::Index j = 0; j < probs.cols(); ++j) {
+        auto p = probs.col(j).segment(actions[j] * atoms_, atoms_);
+        dlogits.col(j).segment(actions[j] * atoms_, atoms_) = p - targets.col(j);
+        loss -= (targets.col(j).array() * p.array().max(1e-12).log()).sum();
+    }
+    return applyLogitGradient(features, dlogits, learning_rate);
+}
+
+Eigen::MatrixXd DistributionalHead::backwardQ(const Eigen::MatrixXd& features,
+                                              const Eigen::MatrixXd& q_targets,
+                                              double learning_rate, double& loss) {
+    // Q_a = sum_i z_i p_ai, so dQ_a/dlogit_ai = p_ai (z_i - Q_a)
+    Eigen::MatrixXd probs = distributions(features);
+    Eigen::MatrixXd dlogits(probs.rows(), probs.cols());
+    loss = 0.0;
+    for (int a = 0; a < num_actions_; ++a) {
+        auto p = probs.middleRows(a * atoms_, atoms_);
+        Eigen::RowVectorXd q = support_.transpose() * p;
+        Eigen::RowVectorXd dq = q - q_targets.row(a);
+        loss += 0.5 * dq.squaredNorm();
+        
+        for (Eigen::Index j = 0; j < p.cols(); ++j) {
+            dlogits.col(j).segment(a * atoms_, atoms_) =
+                dq(j) * (p.col(j).array() * (support_.array() - q(j))).matrix();
+        }
+    }
+    return applyLogitGradient(features, dlogits, learning_rate);
+}
+
+Eigen::MatrixXd DistributionalHead::applyLogitGradient(const Eigen::MatrixXd& features,
+                                                       const Eigen::MatrixXd& dlogits,
+                                                       double learning_rate) {
+    Eigen::MatrixXd feature_grad = weights_.transpose() * dlogits;
+    weights_.noalias() -= learning_rate * (dlogits * features.transpose());
+    bias_ -= learning_rate * dlogits.rowwise().sum();
+    return feature_grad;
+}
+
+void DistributionalHead::save(std::ostream& out) const {
+    writeMatrix(out, weights_);
+    writeMatrix(out, bias_);
+}
+
+void DistributionalHead::load(std::istream& in) {
+    readMatrix(in, weights_);
+    readMatrix(in, bias_);
+}
+
+} // namespace MusicAI
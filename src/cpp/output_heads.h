@@ -0,0 +1,186 @@
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <random>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+enum class HeadType {
+    LINEAR_Q = 0,        // Q(s, a) = W h + b
+    DUELING = 1,         // Q(s, a) = V(s) + A(s, a) - mean_a A(s, a)
+    DISTRIBUTIONAL = 2   // C51: softmax over fixed return atoms per action
+};
+
+struct HeadConfig {
+    HeadType type = HeadType::LINEAR_Q;
+    int atoms = 51;        // Distributional support size
+    double v_min = -10.0;  // Distributional support range
+    double v_max = 10.0;
+};
+
+// Output layer of the Q-network: maps the last hidden features (one column
+// per sample) to action values and owns the matching TD loss.
+class OutputHead {
+public:
+    virtual ~OutputHead() = default;
+    
+    virtual HeadType type() const = 0;
+    virtual std::unique_ptr<OutputHead> clone() const = 0;
+    virtual int inputSize() const = 0;
+    virtual int numActions() const = 0;
+    
+    // Expected action values (numActions x batch)
+    virtual Eigen::MatrixXd forward(const Eigen::MatrixXd& features) const = 0;
+    
+    // Bellman targets evaluated on this (target) head for the chosen next
+    // actions; discounts are 0 for terminal transitions. Value heads return
+    // 1 x batch scalar targets, the distributional head atoms x batch
+    // projected target distributions.
+    virtual Eigen::MatrixXd bellmanTargets(const Eigen::MatrixXd& next_features,
+                                           const std::vector<int>& next_actions,
+                                           const Eigen::VectorXd& rewards,
+                                           const Eigen::VectorXd& discounts) const = 0;
+    
+    // One gradient step on the TD loss for the taken actions (squared error
+    // for value heads, cross-entropy for the distributional head). Returns
+    // dLoss/dfeatures; `loss` receives the summed batch loss.
+    virtual Eigen::MatrixXd backwardTD(const Eigen::MatrixXd& features,
+                                       const std::vector<int>& actions,
+                                       const Eigen::MatrixXd& targets,
+                                       double learning_rate, double& loss) = 0;
+    
+    // One gradient step on squared error against full Q-value targets
+    // (numActions x batch), e.g. for distillation
+    virtual Eigen::MatrixXd backwardQ(const Eigen::MatrixXd& features,
+                                      const Eigen::MatrixXd& q_targets,
+                                      double learning_rate, double& loss) = 0;
+    
+    // Serialization of the head parameters (shape is given by the constructor)
+    virtual void save(std::ostream& out) const = 0;
+    virtual void load(std::istream& in) = 0;
+};
+
+// Known head type and, for the distributional head, 2..MAX_ATOMS atoms over
+// a finite range with v_max > v_min
+bool validHeadConfig(const HeadConfig& config);
+
+std::unique_ptr<OutputHead> makeOutputHead(const HeadConfig& config, int input_size,
+                                           int num_actions, std::mt19937& gen);
+
+class LinearQHead : public OutputHead {
+private:
+    Eigen::MatrixXd weights_;
+    Eigen::VectorXd bias_;
+    
+public:
+    LinearQHead(int input_size, int num_actions, std::mt19937& gen);
+    LinearQHead(const Eigen::MatrixXd& weights, const Eigen::VectorXd& bias);
+    
+    HeadType type() const override { return HeadType::LINEAR_Q; }
+    std::unique_ptr<OutputHead> clone() const override;
+    int inputSize() const override { return static_cast<int>(weights_.cols()); }
+    int numActions() const override { return static_cast<int>(weights_.rows()); }
+    
+    Eigen::MatrixXd forward(const Eigen::MatrixXd& features) const override;
+    Eigen::MatrixXd bellmanTargets(const Eigen::MatrixXd& next_features,
+                                   const std::vector<int>& next_actions,
+                                   const Eigen::VectorXd& rewards,
+                                   const Eigen::VectorXd& discounts) const override;
+    Eigen::MatrixXd backwardTD(const Eigen::MatrixXd& features, const std::vector<int>& actions,
+                               const Eigen::MatrixXd& targets, double learning_rate,
+                               double& loss) override;
+    Eigen::MatrixXd backwardQ(const Eigen::MatrixXd& features, const Eigen::MatrixXd& q_targets,
+                              double learning_rate, double& loss) override;
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
+    
+    const Eigen::MatrixXd& weights() const { return weights_; }
+    const Eigen::VectorXd& bias() const { return bias_; }
+    
+private:
+    Eigen::MatrixXd applyQGradient(const Eigen::MatrixXd& features, const Eigen::MatrixXd& dq,
+                                   double learning_rate);
+};
+
+class DuelingHead : public OutputHead {
+private:
+    Eigen::RowVectorXd value_weights_;
+    double value_bias_;
+    Eigen::MatrixXd advantage_weights_;
+    Eigen::VectorXd advantage_bias_;
+    
+public:
+    DuelingHead(int input_size, int num_actions, std::mt19937& gen);
+    
+    HeadType type() const override { return HeadType::DUELING; }
+    std::unique_ptr<OutputHead> clone() const override;
+    int inputSize() const override { return static_cast<int>(advantage_weights_.cols()); }
+    int numActions() const override { return static_cast<int>(advantage_weights_.rows()); }
+    
+    Eigen::MatrixXd forward(const Eigen::MatrixXd& features) const override;
+    Eigen::MatrixXd bellmanTargets(const Eigen::MatrixXd& next_features,
+                                   const std::vector<int>& next_actions,
+                                   const Eigen::VectorXd& rewards,
+                                   const Eigen::VectorXd& discounts) const override;
+    Eigen::MatrixXd backwardTD(const Eigen::MatrixXd& features, const std::vector<int>& actions,
+                               const Eigen::MatrixXd& targets, double learning_rate,
+                               double& loss) override;
+    Eigen::MatrixXd backwardQ(const Eigen::MatrixXd& features, const Eigen::MatrixXd& q_targets,
+                              double learning_rate, double& loss) override;
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
+    
+private:
+    Eigen::MatrixXd applyQGradient(const Eigen::MatrixXd& features, const Eigen::MatrixXd& dq,
+                                   double learning_rate);
+};
+
+class DistributionalHead : public OutputHead {
+private:
+    int num_actions_;
+    int atoms_;
+    double v_min_;
+    double v_max_;
+    Eigen::VectorXd support_;    // Return value of each atom
+    Eigen::MatrixXd weights_;    // (num_actions * atoms) x input, action-major
+    Eigen::VectorXd bias_;
+    
+public:
+    static constexpr int MAX_ATOMS = 1024;
+    
+    DistributionalHead(int input_size, int num_actions, int atoms,
+                       double v_min, double v_max, std::mt19937& gen);
+    
+    HeadType type() const override { return HeadType::DISTRIBUTIONAL; }
+    std::unique_ptr<OutputHead> clone() const override;
+    int inputSize() const override { return static_cast<int>(weights_.cols()); }
+    int numActions() const override { return num_actions_; }
+    int atoms() const { return atoms_; }
+    double vMin() const { return v_min_; }
+    double vMax() const { return v_max_; }
+    
+    // Per-action return distributions ((num_actions * atoms) x batch)
+    Eigen::MatrixXd distributions(const Eigen::MatrixXd& features) const;
+    
+    Eigen::MatrixXd forward(const Eigen::MatrixXd& features) const override;
+    Eigen::MatrixXd bellmanTargets(const Eigen::MatrixXd& next_features,
+                                   const std::vector<int>& next_actions,
+                                   const Eigen::VectorXd& rewards,
+                                   const Eigen::VectorXd& discounts) const override;
+    Eigen::MatrixXd backwardTD(const Eigen::MatrixXd& features, const std::vector<int>& actions,
+                               const Eigen::MatrixXd& targets, double learning_rate,
+                               double& loss) override;
+    Eigen::MatrixXd backwardQ(const Eigen::MatrixXd& features, const Eigen::MatrixXd& q_targets,
+                              double learning_rate, double& loss) override;
+    void save(std::ostream& out) const override;
+    void load(std::istream& in) override;
+    
+private:
+    Eigen::MatrixXd applyLogitGradient(const Eigen::MatrixXd& features,
+                                       const Eigen::MatrixXd& dlogits, double learning_rate);
+};
+
+} // namespace MusicAI
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace MusicAI {
+
+// Number of worker threads to use for a requested count (0 = all cores).
+// Builds without thread support always run on the calling thread.
+inline unsigned resolveThreadCount(unsigned requested) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    (void)requested;
+    return 1;
+#else
+    if (requested == 0) {
+        requested = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return requested;
+#endif
+}
+
+// Splits [0, count) into contiguous ranges of at least min_chunk items and
+// runs fn(begin, end) for each range on up to num_threads threads. The
+// calling thread takes the first range; small inputs run inline.
+template <typename Fn>
+void parallelFor(size_t count, unsigned num_threads, Fn&& fn, size_t min_chunk = 1) {
+    if (count == 0) {
+        return;
+    }
+    size_t max_ranges = (count + min_chunk - 1) / std::max<size_t>(min_chunk, 1);
+    size_t ranges = std::min<size_t>(resolveThreadCount(num_threads), max_ranges);
+    if (ranges <= 1) {
+        fn(size_t(0), count);
+        return;
+    }
+    
+    size_t chunk = (count + ranges - 1) / ranges;
+    std::vector<std::thread> workers;
+    workers.reserve(ranges - 1);
+    for (size_t r = 1; r < ranges; ++r) {
+        size_t begin = r * chunk;
+        size_t end = std::min(count, begin + chunk);
+        if (begin >= end) {
+            break;
+        }
+        workers.emplace_back([&fn, begin, end]() { fn(begin, end); });
+    }
+    fn(size_t(0), std::min(count, chunk));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace MusicAI
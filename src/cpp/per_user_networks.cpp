@@ -0,0 +1,113 @@
+#include "per_user_networks.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace MusicAI {
+
+PerUserNetworks::PerUserNetworks(const NeuralNetwork& base)
+    : params_per_user_(0), max_width_(NeuralNetwork::INPUT_SIZE) {
+    if (base.getHead().type() != HeadType::LINEAR_Q) {
+        throw std::invalid_argument("Per-user networks need a linear Q head");
+    }
+    
+    NeuralNetwork::Architecture architecture = base.getArchitecture();
+    int cols = NeuralNetwork::INPUT_SIZE;
+    for (size_t i = 0; i <= architecture.hidden_sizes.size(); ++i) {
+        bool output = i == architecture.hidden_sizes.size();
+        Layer layer;
+        layer.rows = output ? base.getHead().numActions() : architecture.hidden_sizes[i];
+        layer.cols = cols;
+        layer.activation = output ? NeuralNetwork::Activation::LINEAR : architecture.activations[i];
+        layer.weight_offset = params_per_user_;
+        layer.bias_offset = params_per_user_ + static_cast<size_t>(layer.rows) * layer.cols;
+        params_per_user_ = layer.bias_offset + layer.rows;
+        max_width_ = std::max(max_width_, layer.rows);
+        layers_.push_back(layer);
+        cols = layer.rows;
+    }
+    flatten(base, base_params_);
+}
+
+void PerUserNetworks::flatten(const NeuralNetwork& network, std::vector<double>& params) const {
+    const auto* head = dynamic_cast<const LinearQHead*>(&network.getHead());
+    if (!head) {
+        throw std::invalid_argument("Per-user networks need a linear Q head");
+    }
+    
+    params.resize(params_per_user_);
+    for (size_t i = 0; i < layers_.size(); ++i) {
+        const Layer& layer = layers_[i];
+        bool output = i + 1 == layers_.size();
+        const Eigen::MatrixXd& weight = output ? head->weights() : network.getLayerWeights(static_cast<int>(i));
+        const Eigen::VectorXd& bias = output ? head->bias() : network.getLayerBias(static_cast<int>(i));
+        if (weight.rows() != layer.rows || weight.cols() != layer.cols) {
+            throw std::invalid_argument("Network does not match the per-user topology");
+        }
+        
+        Eigen::Map<Eigen::MatrixXd>(params.data() + layer.weight_offset, layer.rows, layer.cols) = weight;
+        Eigen::Map<Eigen::VectorXd>(params.data() + layer.bias_offset, layer.rows) = bias;
+    }
+}
+
+void PerUserNetworks::writeSlot(uint32_t slot, const std::vector<double>& params) {
+    size_t needed = (static_cast<size_t>(slot) + 1) * params_per_user_;
+    if (params_.size() < needed) {
+        params_.resize(needed);
+    }
+    std::copy(params.begin(), params.end(), params_.begin() + slot * params_per_user_);
+}
+
+uint32_t PerUserNetworks::addUser(uint64_t user_id) {
+    auto found = slots_.find(user_id);
+    if (found != slots_.end()) {
+        return found->second;
+    }
+    uint32_t slot = static_cast<uint32_t>(slots_.size());
+    writeSlot(slot, base_params_);
+    slots_.emplace(user_id, slot);
+    return slot;
+}
+
+void PerUserNetworks::setUser(uint64_t user_id, const NeuralNetwork& network) {
+    std::vector<double> params;
+    flatten(network, params);
+    writeSlot(addUser(user_id), params);
+}
+
+void PerUserNetworks::evaluate(const std::vector<uint64_t>& users, const Eigen::MatrixXd& states,
+                               Eigen::MatrixXd& q_values, unsigned num_threads) const {
+    if (states.rows() != NeuralNetwork::INPUT_SIZE || static_cast<size_t>(states.cols()) != users.size()) {
+        throw std::invalid_argument("Need one state column per user");
+    }
+    
+    std::vector<uint32_t> slots(users.size());
+    for (size_t i = 0; i < users.size(); ++i) {
+        auto found = slots_.find(users[i]);
+        if (found == slots_.end()) {
+            throw std::out_of_range("Unknown user " + std::to_string(users[i]));
+        }
+        slots[i] = found->second;
+    }
+    
+    q_values.resize(layers_.back().rows, states.cols());
+    parallelFor(slots.size(), num_threads, [&](size_t begin, size_t end) {
+        Eigen::VectorXd current(max_width_);
+        Eigen::VectorXd next(max_width_);
+        for (size_t i = begin; i < end; ++i) {
+            const double* params = params_.data() + static_cast<size_t>(slots[i]) * params_per_user_;
+            current.head(NeuralNetwork::INPUT_SIZE) = states.col(i);
+            for (const Layer& layer : layers_) {
+                next.head(layer.rows).noalias() =
+                    Eigen::Map<const Eigen::MatrixXd>(params + layer.weight_offset, layer.rows, layer.cols) *
+                    current.head(layer.cols);
+                next.head(layer.rows) += Eigen::Map<const Eigen::VectorXd>(params + layer.bias_offset, layer.rows);
+                NeuralNetwork::applyActivation(next.head(layer.rows), layer.activation);
+                current.swap(next);
+            }
+            q_values.col(i) = current.head(layers_.back().rows);
+        }
+    }, 64);
+}
+
+} // namespace MusicAI
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "neural_network.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace MusicAI {
+
+// One small Q-network per user, all with the topology of a base network
+// that has a linear Q head. Parameters live in one contiguous arena rather
+// than one NeuralNetwork per user (each user's parameters contiguous,
+// column-major per layer), and a batch of requests from arbitrary users is
+// evaluated through Eigen maps of each user's slice into reused buffers, so
+// there is no per-request allocation or per-network indirection.
+class PerUserNetworks {
+private:
+    struct Layer {
+        int rows;
+        int cols;
+        NeuralNetwork::Activation activation;
+        size_t weight_offset;  // Within one user's parameters
+        size_t bias_offset;
+    };
+    
+    std::vector<Layer> layers_;
+    size_t params_per_user_;
+    int max_width_;
+    std::vector<double> base_params_;               // Flattened copy of the base network
+    std::vector<double> params_;                    // Arena, params_per_user_ per slot
+    std::unordered_map<uint64_t, uint32_t> slots_;  // User ID -> arena slot
+    
+public:
+    explicit PerUserNetworks(const NeuralNetwork& base);
+    
+    // Adds a user initialized from the base network; returns its slot.
+    // Existing users keep their parameters.
+    uint32_t addUser(uint64_t user_id);
+    
+    // Copies a network with the base topology into the user's slot
+    void setUser(uint64_t user_id, const NeuralNetwork& network);
+    
+    bool hasUser(uint64_t user_id) const { return slots_.count(user_id) != 0; }
+    size_t numUsers() const { return slots_.size(); }
+    size_t parametersPerUser() const { return params_per_user_; }
+    
+    // Q-values (numActions x batch) for states (one per column) of the given
+    // users. Throws std::out_of_range for unknown users.
+    void evaluate(const std::vector<uint64_t>& users, const Eigen::MatrixXd& states,
+                  Eigen::MatrixXd& q_values, unsigned num_threads = 1) const;
+    
+private:
+    void flatten(const NeuralNetwork& network, std::vector<double>& params) const;
+    void writeSlot(uint32_t slot, const std::vector<double>& params);
+};
+
+} // namespace MusicAI
@@ -0,0 +1,197 @@
+#include "playlist_builder.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+// Candidate evaluations per thread below which a step stays on one thread;
+// steps are tens of microseconds, comparable to starting a thread
+constexpr size_t PARALLEL_GRAIN = size_t(1) << 16;
+
+struct Beam {
+    std::vector<int> candidates;  // Pool indices in playlist order
+    std::vector<int> genres;
+    std::array<double, 3> history;
+    Eigen::VectorXf profile;      // Decaying sum of chosen track embeddings
+    std::vector<uint64_t> used;   // Bitset over the candidate pool
+    double score = 0.0;
+};
+
+struct Extension {
+    int beam;
+    int genre;
+    int candidate;
+    double score;
+};
+
+bool betterExtension(const Extension& a, const Extension& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    // Deterministic tie-break so results do not depend on thread count
+    if (a.beam != b.beam) {
+        return a.beam < b.beam;
+    }
+    return a.candidate < b.candidate;
+}
+
+} // namespace
+
+PlaylistBuilder::PlaylistBuilder(const NeuralNetwork& network, const TrackCatalog& catalog, const Config& config)
+    : network_(network), catalog_(catalog), config_(config) {
+    if (network_.getInputSize() != NeuralNetwork::INPUT_SIZE) {
+        throw std::invalid_argument("Playlist builder needs a network over the 8 session features");
+    }
+    if (config_.beam_width < 1 || config_.expansions_per_genre < 1) {
+        throw std::invalid_argument("Beam width and expansions must be positive");
+    }
+    genre_actions_.assign(catalog_.genreNames().size(), -1);
+    for (int action = 0; action < NUM_GENRES; ++action) {
+        int code = catalog_.genreCode(MusicEnvironment::actionToString(static_cast<MusicEnvironment::Action>(action)));
+        if (code >= 0) {
+            genre_actions_[code] = action;
+        }
+    }
+}
+
+PlaylistBuilder::Playlist PlaylistBuilder::build(const MusicEnvironment::State& context,
+                                                 const std::vector<Candidate>& candidates, int length) const {
+    if (length < 0) {
+        throw std::invalid_argument("Playlist length must be non-negative");
+    }
+    
+    // Split the pool by genre and gather unit-length embeddings (dim x pool)
+    const int dim = catalog_.embeddingDim();
+    const auto embeddings = catalog_.embeddings();
+    const uint8_t* codes = catalog_.genreCodes();
+    std::vector<std::vector<int>> pools(NUM_GENRES);
+    Eigen::MatrixXf pool_embeddings(dim, candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        uint32_t track = candidates[c].track;
+        if (track >= catalog_.size()) {
+            throw std::out_of_range("Candidate track not in catalog");
+        }
+        pool_embeddings.col(c) = embeddings.col(track);
+        float norm = pool_embeddings.col(c).norm();
+        if (norm > 0.0f) {
+            pool_embeddings.col(c) /= norm;
+        }
+        int action = genre_actions_[codes[track]];
+        if (action >= 0) {
+            pools[action].push_back(static_cast<int>(c));
+        }
+    }
+    
+    const size_t used_words = (candidates.size() + 63) / 64;
+    std::vector<Beam> beams(1);
+    beams[0].history = context.genre_history;
+    beams[0].profile = Eigen::VectorXf::Zero(dim);
+    beams[0].used.assign(used_words, 0);
+    
+    // Session features are fixed; only the genre history changes per beam
+    std::vector<double> features = MusicEnvironment::stateToVector(context);
+    Eigen::MatrixXd inputs(NeuralNetwork::INPUT_SIZE, config_.beam_width);
+    for (int i = 0; i < NeuralNetwork::INPUT_SIZE; ++i) {
+        inputs.row(i).setConstant(features[i]);
+    }
+    Eigen::MatrixXd q_values;
+    auto evaluate = [&]() {
+        for (size_t b = 0; b < beams.size(); ++b) {
+            for (int h = 0; h < 3; ++h) {
+                inputs(5 + h, b) = beams[b].history[h];
+            }
+        }
+        q_values = network_.forwardBatch(inputs.leftCols(beams.size()));
+    };
+    evaluate();
+    
+    const size_t pool_size = std::max<size_t>(1, candidates.size());
+    const size_t min_beams = std::max<size_t>(1, PARALLEL_GRAIN / pool_size);
+    const size_t keep = static_cast<size_t>(config_.expansions_per_genre);
+    Eigen::MatrixXf profiles;
+    Eigen::MatrixXf similarity;
+    std::vector<std::vector<Extension>> extensions;
+    std::vector<Extension> merged;
+    
+    for (int step = 0; step < length; ++step) {
+        // Cosine similarity of every candidate to every beam's profile
+        profiles.resize(dim, beams.size());
+        for (size_t b = 0; b < beams.size(); ++b) {
+            float norm = beams[b].profile.norm();
+            profiles.col(b) = norm > 0.0f ? (beams[b].profile / norm).eval() : beams[b].profile;
+        }
+        similarity.noalias() = pool_embeddings.transpose() * profiles;
+        
+        extensions.assign(beams.size(), {});
+        parallelFor(beams.size(), config_.num_threads, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                const Beam& beam = beams[b];
+                std::vector<Extension>& out = extensions[b];
+                for (int genre = 0; genre < NUM_GENRES; ++genre) {
+                    const double base = beam.score + q_values(genre, b) +
+                        config_.consistency_weight *
+                        MusicEnvironment::getGenreConsistency(beam.history, static_cast<MusicEnvironment::Action>(genre));
+                    
+                    // Keep the best `keep` unused tracks of this genre, sorted
+                    const size_t first = out.size();
+                    for (int c : pools[genre]) {
+                        if ((beam.used[c >> 6] >> (c & 63)) & 1) {
+                            continue;
+                        }
+                        Extension extension{static_cast<int>(b), genre, c,
+                                            base + config_.relevance_weight * candidates[c].relevance -
+                                                config_.diversity_weight * similarity(c, b)};
+                        if (out.size() - first == keep) {
+                            if (!betterExtension(extension, out.back())) {
+                                continue;
+                            }
+                            out.pop_back();
+                        }
+                        auto position = std::upper_bound(out.begin() + first, out.end(), extension, betterExtension);
+                        out.insert(position, extension);
+                    }
+                }
+            }
+        }, min_beams);
+        
+        merged.clear();
+        for (const auto& beam_extensions : extensions) {
+            merged.insert(merged.end(), beam_extensions.begin(), beam_extensions.end());
+        }
+        if (merged.empty()) {
+            break;  // Pool exhausted
+        }
+        size_t width = std::min(merged.size(), static_cast<size_t>(config_.beam_width));
+        std::partial_sort(merged.begin(), merged.begin() + width, merged.end(), betterExtension);
+        
+        std::vector<Beam> next(width);
+        for (size_t i = 0; i < width; ++i) {
+            const Extension& extension = merged[i];
+            Beam& beam = next[i];
+            beam = beams[extension.beam];
+            beam.candidates.push_back(extension.candidate);
+            beam.genres.push_back(extension.genre);
+            beam.history = {extension.genre / 4.0, beam.history[0], beam.history[1]};
+            beam.profile = static_cast<float>(config_.profile_decay) * beam.profile +
+                           pool_embeddings.col(extension.candidate);
+            beam.used[extension.candidate >> 6] |= uint64_t(1) << (extension.candidate & 63);
+            beam.score = extension.score;
+        }
+        beams.swap(next);
+        evaluate();
+    }
+    
+    // Beams stay sorted best-first after each step
+    Playlist playlist;
+    playlist.score = beams[0].score;
+    playlist.genres = beams[0].genres;
+    for (int c : beams[0].candidates) {
+        playlist.tracks.push_back(candidates[c].track);
+    }
+    return playlist;
+}
+
+} // namespace MusicAI
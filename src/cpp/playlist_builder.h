@@ -0,0 +1,65 @@
+#pragma once
+
+#include "music_environment.h"
+#include "neural_network.h"
+#include "track_catalog.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <vector>
+
+namespace MusicAI {
+
+// Builds track playlists by beam search over the Q-network and a candidate
+// pool from the catalog. Each step extends every beam by one track: the
+// extension score is the Q-value of the track's genre in the beam's state,
+// plus a genre-consistency bonus (MusicEnvironment::getGenreConsistency) and
+// the candidate's retrieval relevance, minus a diversity penalty (cosine
+// similarity to a decaying profile of the beam's recent tracks). One batched
+// forward per step evaluates the Q-values of all surviving beams, and
+// candidate scoring is split across beams. Catalog genres map to actions by
+// MusicEnvironment::actionToString name; other genres are never picked.
+class PlaylistBuilder {
+public:
+    static constexpr int NUM_GENRES = NeuralNetwork::OUTPUT_SIZE;
+    
+    struct Config {
+        int beam_width = 8;
+        int expansions_per_genre = 2;     // Best tracks per (beam, genre) considered
+        double consistency_weight = 0.2;
+        double relevance_weight = 0.5;
+        double diversity_weight = 0.3;
+        double profile_decay = 0.7;       // Weight of older tracks in the diversity profile
+        unsigned num_threads = 0;         // 0 = all cores
+    };
+    
+    struct Candidate {
+        uint32_t track;
+        float relevance;  // Higher is better, e.g. negated index distance
+    };
+    
+    struct Playlist {
+        std::vector<uint32_t> tracks;
+        std::vector<int> genres;
+        double score = 0.0;
+    };
+    
+private:
+    const NeuralNetwork& network_;
+    const TrackCatalog& catalog_;
+    Config config_;
+    std::vector<int> genre_actions_;  // Action per catalog genre code, -1 if none
+    
+public:
+    PlaylistBuilder(const NeuralNetwork& network, const TrackCatalog& catalog, const Config& config);
+    PlaylistBuilder(const NeuralNetwork& network, const TrackCatalog& catalog)
+        : PlaylistBuilder(network, catalog, Config()) {}
+    
+    // Highest-scoring playlist of up to `length` distinct candidate tracks
+    // (shorter only if the pool runs out), starting from `context`
+    Playlist build(const MusicEnvironment::State& context, const std::vector<Candidate>& candidates,
+                   int length) const;
+    
+    const Config& getConfig() const { return config_; }
+};
+
+} // namespace MusicAI
@@ -0,0 +1,231 @@
+#include "policy_table.h"
+#include "mapped_file.h"
+#include "parallel_for.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+// Table files: a fixed header, the action bytes padded to 8 bytes, then
+// the fp16 Q-values (cell-major) if present
+constexpr uint32_t TABLE_MAGIC = 0x5450514D;  // "MQPT"
+constexpr uint32_t TABLE_VERSION = 1;
+constexpr size_t BUILD_BATCH = 4096;
+
+struct TableHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_actions;
+    uint32_t has_q_values;
+    struct {
+        double lo;
+        double hi;
+        int32_t levels;
+        int32_t reserved;
+    } axes[PolicyTable::STATE_SIZE];
+    uint64_t cells;
+};
+
+// Largest grid whose file (header, padded actions, fp16 Q-values) still
+// has a size that fits in size_t
+constexpr size_t MAX_CELLS = (std::numeric_limits<size_t>::max() - sizeof(TableHeader)) /
+                             (PolicyTable::NUM_ACTIONS * sizeof(Eigen::half) + 2);
+
+size_t paddedActionBytes(size_t cells) {
+    return (cells + 7) & ~size_t(7);
+}
+
+} // namespace
+
+size_t PolicyTable::Grid::cells() const {
+    size_t cells = 1;
+    for (const Axis& axis : axes) {
+        // Levels may come from a file, so check before multiplying
+        if (axis.levels < 1) {
+            throw std::invalid_argument("Invalid policy table axis");
+        }
+        if (cells > MAX_CELLS / static_cast<size_t>(axis.levels)) {
+            throw std::invalid_argument("Policy table grid is too large");
+        }
+        cells *= static_cast<size_t>(axis.levels);
+    }
+    return cells;
+}
+
+PolicyTable::PolicyTable(const Grid& grid)
+    : grid_(grid), cells_(grid.cells()), actions_(nullptr), q_values_(nullptr) {
+    for (const Axis& axis : grid_.axes) {
+        if (axis.levels < 1 || (axis.levels > 1 && !(axis.hi > axis.lo))) {
+            throw std::invalid_argument("Invalid policy table axis");
+        }
+    }
+    // Last feature varies fastest
+    size_t stride = 1;
+    for (int d = STATE_SIZE - 1; d >= 0; --d) {
+        const Axis& axis = grid_.axes[d];
+        strides_[d] = stride;
+        scales_[d] = axis.levels > 1 ? (axis.levels - 1) / (axis.hi - axis.lo) : 0.0;
+        stride *= static_cast<size_t>(axis.levels);
+    }
+}
+
+PolicyTable PolicyTable::build(const NeuralNetwork& network, const Grid& grid,
+                               bool store_q_values, unsigned num_threads) {
+    PolicyTable table(grid);
+    table.owned_actions_.resize(table.cells_);
+    if (store_q_values) {
+        table.owned_q_values_.resize(table.cells_ * NUM_ACTIONS);
+    }
+    
+    size_t num_batches = (table.cells_ + BUILD_BATCH - 1) / BUILD_BATCH;
+    parallelFor(num_batches, num_threads, [&](size_t batch_begin, size_t batch_end) {
+        Eigen::MatrixXd inputs(STATE_SIZE, BUILD_BATCH);
+        for (size_t b = batch_begin; b < batch_end; ++b) {
+            size_t first = b * BUILD_BATCH;
+            size_t count = std::min(BUILD_BATCH, table.cells_ - first);
+            for (size_t i = 0; i < count; ++i) {
+                inputs.col(i) = table.cellState(first + i);
+            }
+            
+            Eigen::MatrixXd q = network.forwardBatch(inputs.leftCols(count));
+            for (size_t i = 0; i < count; ++i) {
+                Eigen::Index best;
+                q.col(i).maxCoeff(&best);
+                table.owned_actions_[first + i] = static_cast<uint8_t>(best);
+            }
+            if (store_q_values) {
+                Eigen::Map<Eigen::Matrix<Eigen::half, Eigen::Dynamic, Eigen::Dynamic>> out(
+                    table.owned_q_values_.data() + first * NUM_ACTIONS, NUM_ACTIONS, count);
+                out = q.cast<Eigen::half>();
+            }
+        }
+    });
+    
+    table.actions_ = table.owned_actions_.data();
+    table.q_values_ = store_q_values ? table.owned_q_values_.data() : nullptr;
+    return table;
+}
+
+void PolicyTable::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filename);
+    }
+    
+    TableHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = TABLE_MAGIC;
+    header.version = TABLE_VERSION;
+    header.num_actions = NUM_ACTIONS;
+    header.has_q_values = hasQValues() ? 1 : 0;
+    for (int d = 0; d < STATE_SIZE; ++d) {
+        header.axes[d].lo = grid_.axes[d].lo;
+        header.axes[d].hi = grid_.axes[d].hi;
+        header.axes[d].levels = grid_.axes[d].levels;
+    }
+    header.cells = cells_;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    file.write(reinterpret_cast<const char*>(actions_), cells_);
+    const char padding[8] = {};
+    file.write(padding, paddedActionBytes(cells_) - cells_);
+    if (hasQValues()) {
+        file.write(reinterpret_cast<const char*>(q_values_), cells_ * NUM_ACTIONS * sizeof(Eigen::half));
+    }
+    if (!file) {
+        throw std::runtime_error("Failed to write policy table: " + filename);
+    }
+}
+
+PolicyTable PolicyTable::load(const std::string& filename) {
+    MappedFile file = MappedFile::open(filename);
+    const size_t file_size = file.size;
+    
+    const char* bytes = static_cast<const char*>(file.data.get());
+    if (file_size < sizeof(TableHeader)) {
+        throw std::runtime_error("Truncated policy table: " + filename);
+    }
+    TableHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != TABLE_MAGIC || header.version != TABLE_VERSION ||
+        header.num_actions != static_cast<uint32_t>(NUM_ACTIONS)) {
+        throw std::runtime_error("Not a compatible policy table: " + filename);
+    }
+    
+    Grid grid;
+    for (int d = 0; d < STATE_SIZE; ++d) {
+        grid.axes[d] = {header.axes[d].lo, header.axes[d].hi, header.axes[d].levels};
+    }
+    PolicyTable table(grid);
+    if (header.cells != table.cells_) {
+        throw std::runtime_error("Policy table grid does not match its size: " + filename);
+    }
+    size_t expected = sizeof(TableHeader) + paddedActionBytes(table.cells_) +
+                      (header.has_q_values ? table.cells_ * NUM_ACTIONS * sizeof(Eigen::half) : 0);
+    if (file_size < expected) {
+        throw std::runtime_error("Truncated policy table: " + filename);
+    }
+    
+    table.actions_ = reinterpret_cast<const uint8_t*>(bytes + sizeof(TableHeader));
+    if (header.has_q_values) {
+        table.q_values_ = reinterpret_cast<const Eigen::half*>(
+            bytes + sizeof(TableHeader) + paddedActionBytes(table.cells_));
+    }
+    table.mapping_ = std::move(file.data);
+    return table;
+}
+
+size_t PolicyTable::cellIndex(const double* state) const {
+    size_t index = 0;
+    for (int d = 0; d < STATE_SIZE; ++d) {
+        // Snap to the nearest level, clamping out-of-range features
+        double max_level = static_cast<double>(grid_.axes[d].levels - 1);
+        double position = (state[d] - grid_.axes[d].lo) * scales_[d];
+        position = std::max(0.0, std::min(max_level, position));
+        index += static_cast<size_t>(position + 0.5) * strides_[d];
+    }
+    return index;
+}
+
+int PolicyTable::action(const Eigen::VectorXd& state) const {
+    if (state.size() != STATE_SIZE) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    return action(state.data());
+}
+
+Eigen::VectorXd PolicyTable::qValues(const Eigen::VectorXd& state) const {
+    if (state.size() != STATE_SIZE) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    if (!q_values_) {
+        throw std::logic_error("Policy table was built without Q-values");
+    }
+    Eigen::Map<const Eigen::Matrix<Eigen::half, Eigen::Dynamic, 1>> q(
+        q_values_ + cellIndex(state.data()) * NUM_ACTIONS, NUM_ACTIONS);
+    return q.cast<double>();
+}
+
+Eigen::VectorXd PolicyTable::cellState(size_t cell) const {
+    Eigen::VectorXd state(STATE_SIZE);
+    for (int d = 0; d < STATE_SIZE; ++d) {
+        const Axis& axis = grid_.axes[d];
+        size_t level = (cell / strides_[d]) % static_cast<size_t>(axis.levels);
+        state(d) = axis.levels == 1
+            ? axis.lo
+            : axis.lo + (axis.hi - axis.lo) * static_cast<double>(level) / (axis.levels - 1);
+    }
+    return state;
+}
+
+size_t PolicyTable::sizeBytes() const {
+    return sizeof(TableHeader) + paddedActionBytes(cells_) +
+           (hasQValues() ? cells_ * NUM_ACTIONS * sizeof(Eigen::half) : 0);
+}
+
+} // namespace MusicAI
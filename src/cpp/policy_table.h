@@ -0,0 +1,93 @@
+#pragma once
+
+#include "neural_network.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Eigen/Core>
+
+namespace MusicAI {
+
+// Greedy policy (and optionally Q-values) of a network precomputed over a
+// discretized grid of the state space, for clients where even a small
+// forward pass is too much. A lookup snaps each state dimension to its
+// nearest grid level and indexes a flat table: one uint8 action per cell,
+// plus NUM_ACTIONS fp16 Q-values per cell when stored.
+class PolicyTable {
+public:
+    static constexpr int STATE_SIZE = NeuralNetwork::INPUT_SIZE;
+    static constexpr int NUM_ACTIONS = NeuralNetwork::OUTPUT_SIZE;
+    
+    // `levels` evenly spaced grid points from lo to hi (inclusive)
+    struct Axis {
+        double lo;
+        double hi;
+        int levels;
+    };
+    
+    // One axis per network input (MusicEnvironment::stateToVector order and
+    // scale). Defaults: 4 temperature levels, every weather state, 6 hour
+    // buckets, every day, every mood, and the 5 genre values per history slot.
+    struct Grid {
+        std::array<Axis, STATE_SIZE> axes = {{
+            {-1.0, 1.0, 4},        // temperature
+            {0.0, 1.0, 5},         // weather_condition / 4
+            {0.0, 20.0 / 24.0, 6}, // hour_of_day (4-hour buckets)
+            {0.0, 1.0, 7},         // day_of_week
+            {0.0, 1.0, 5},         // user_mood / 4
+            {0.0, 1.0, 5},         // genre_history[0]
+            {0.0, 1.0, 5},         // genre_history[1]
+            {0.0, 1.0, 5}          // genre_history[2]
+        }};
+        
+        size_t cells() const;  // Throws std::invalid_argument for levels < 1 or an oversized grid
+    };
+    
+private:
+    Grid grid_;
+    std::array<size_t, STATE_SIZE> strides_;
+    std::array<double, STATE_SIZE> scales_;  // Grid levels per unit of each feature
+    size_t cells_;
+    
+    // Either owned buffers (after build) or a read-only file mapping (after load)
+    std::vector<uint8_t> owned_actions_;
+    std::vector<Eigen::half> owned_q_values_;
+    std::shared_ptr<const void> mapping_;
+    const uint8_t* actions_;
+    const Eigen::half* q_values_;  // nullptr when Q-values were not stored
+    
+    explicit PolicyTable(const Grid& grid);
+    
+public:
+    PolicyTable(PolicyTable&&) = default;
+    PolicyTable& operator=(PolicyTable&&) = default;
+    PolicyTable(const PolicyTable&) = delete;
+    PolicyTable& operator=(const PolicyTable&) = delete;
+    
+    // Evaluates the network at every grid point with batched forwards split
+    // across num_threads threads (0 = all cores)
+    static PolicyTable build(const NeuralNetwork& network, const Grid& grid,
+                             bool store_q_values = false, unsigned num_threads = 0);
+    
+    void save(const std::string& filename) const;
+    // Maps the file read-only (copies it where mmap is unavailable)
+    static PolicyTable load(const std::string& filename);
+    
+    // Lookups: an index computation plus one load
+    size_t cellIndex(const double* state) const;
+    int action(const double* state) const { return actions_[cellIndex(state)]; }
+    int action(const Eigen::VectorXd& state) const;
+    bool hasQValues() const { return q_values_ != nullptr; }
+    Eigen::VectorXd qValues(const Eigen::VectorXd& state) const;
+    
+    // Grid point a cell was computed at
+    Eigen::VectorXd cellState(size_t cell) const;
+    
+    const Grid& grid() const { return grid_; }
+    size_t cells() const { return cells_; }
+    size_t sizeBytes() const;
+};
+
+} // namespace MusicAI
@@ -0,0 +1,145 @@
+#include "q_value_cache.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t power = 1;
+    while (power < n) {
+        power <<= 1;
+    }
+    return power;
+}
+
+uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    return h ^ (h >> 33);
+}
+
+} // namespace
+
+QValueCache::QValueCache(const Config& config)
+    : config_(config), hits_(0), misses_(0), inserts_(0), evictions_(0) {
+    if (config_.capacity == 0 || config_.num_shards == 0) {
+        throw std::invalid_argument("Q-value cache needs a positive capacity and shard count");
+    }
+    
+    size_t num_shards = nextPowerOfTwo(config_.num_shards);
+    size_t per_shard = nextPowerOfTwo(std::max(MAX_PROBE, (config_.capacity + num_shards - 1) / num_shards));
+    shard_mask_ = num_shards - 1;
+    slot_mask_ = per_shard - 1;
+    
+    shards_.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+        shards_.back()->entries.assign(per_shard, Entry{{}, 0, {}, false});
+    }
+}
+
+QValueCache::Key QValueCache::makeKey(const Eigen::VectorXd& state) const {
+    if (state.size() != STATE_SIZE) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    
+    Key key;
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < STATE_SIZE; ++i) {
+        double step = config_.resolution[i];
+        int64_t cell;
+        if (step > 0.0) {
+            cell = static_cast<int64_t>(std::llround(state(i) / step));
+        } else {
+            double value = state(i) == 0.0 ? 0.0 : state(i);  // Fold -0 onto +0
+            std::memcpy(&cell, &value, sizeof(cell));
+        }
+        key.cells[i] = cell;
+        hash = mix(hash ^ static_cast<uint64_t>(cell));
+    }
+    key.hash = hash;
+    return key;
+}
+
+bool QValueCache::lookup(const Key& key, uint64_t version, Eigen::VectorXd& q_values) {
+    Shard& shard = *shards_[(key.hash >> 48) & shard_mask_];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t probe = 0; probe < MAX_PROBE; ++probe) {
+            const Entry& entry = shard.entries[(key.hash + probe) & slot_mask_];
+            if (!entry.occupied) {
+                break;
+            }
+            if (entry.version == version && entry.cells == key.cells) {
+                q_values = Eigen::Map<const Eigen::VectorXd>(entry.q_values.data(), NUM_ACTIONS);
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void QValueCache::insert(const Key& key, uint64_t version, const Eigen::VectorXd& q_values) {
+    if (q_values.size() != NUM_ACTIONS) {
+        throw std::invalid_argument("Q-value size mismatch");
+    }
+    
+    Shard& shard = *shards_[(key.hash >> 48) & shard_mask_];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    // Reuse the slot holding this key, else the first empty or stale slot in
+    // the probe window, else overwrite the home slot
+    Entry* target = nullptr;
+    for (size_t probe = 0; probe < MAX_PROBE; ++probe) {
+        Entry& entry = shard.entries[(key.hash + probe) & slot_mask_];
+        if (entry.occupied && entry.cells == key.cells) {
+            target = &entry;
+            break;
+        }
+        if (!target && (!entry.occupied || entry.version != version)) {
+            target = &entry;
+        }
+        if (!entry.occupied) {
+            break;
+        }
+    }
+    if (!target) {
+        target = &shard.entries[key.hash & slot_mask_];
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    target->cells = key.cells;
+    target->version = version;
+    Eigen::Map<Eigen::VectorXd>(target->q_values.data(), NUM_ACTIONS) = q_values;
+    target->occupied = true;
+    inserts_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void QValueCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (Entry& entry : shard->entries) {
+            entry.occupied = false;
+        }
+    }
+}
+
+QValueCache::Stats QValueCache::getStats() const {
+    return Stats{hits_.load(), misses_.load(), inserts_.load(), evictions_.load()};
+}
+
+void QValueCache::resetStats() {
+    hits_ = 0;
+    misses_ = 0;
+    inserts_ = 0;
+    evictions_ = 0;
+}
+
+} // namespace MusicAI
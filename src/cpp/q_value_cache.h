@@ -0,0 +1,97 @@
+#pragma once
+
+#include "neural_network.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace MusicAI {
+
+// Bounded result cache for Q-values keyed on a quantized context. Serving
+// contexts are low-cardinality (5 weather states, 5 moods, coarse hour and
+// day), so many requests land on the same key. Entries are tagged with the
+// model version they were computed under; a lookup under any other version
+// misses, so a weight update or hot swap never serves stale values.
+//
+// Storage is split into independently locked shards, each a fixed-size
+// open-addressing table with short linear probes. When a probe window is
+// full the home slot is overwritten, so memory never grows past capacity.
+class QValueCache {
+public:
+    static constexpr int STATE_SIZE = NeuralNetwork::INPUT_SIZE;
+    static constexpr int NUM_ACTIONS = NeuralNetwork::OUTPUT_SIZE;
+    static constexpr size_t MAX_PROBE = 8;
+    
+    struct Config {
+        // Quantization step per state dimension (0 = exact match). Defaults
+        // follow MusicEnvironment::stateToVector: temperature in [-1, 1],
+        // weather and mood scaled to quarters of [0, 1], hour/day in [0, 1],
+        // genre history in steps of one genre (0.25).
+        std::array<double, STATE_SIZE> resolution = {
+            0.1, 0.25, 1.0 / 24.0, 1.0 / 7.0, 0.25, 0.25, 0.25, 0.25
+        };
+        size_t capacity = 16384;  // Total entries across shards (rounded up to powers of two)
+        size_t num_shards = 16;
+    };
+    
+    struct Key {
+        std::array<int64_t, STATE_SIZE> cells;
+        uint64_t hash;
+    };
+    
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t inserts;
+        uint64_t evictions;  // Live entries overwritten because their probe window was full
+        
+        double hitRate() const {
+            uint64_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+    
+private:
+    struct Entry {
+        std::array<int64_t, STATE_SIZE> cells;
+        uint64_t version;
+        std::array<double, NUM_ACTIONS> q_values;
+        bool occupied;
+    };
+    
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+    };
+    
+    Config config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t slot_mask_;   // Entries per shard - 1
+    size_t shard_mask_;  // Shards - 1
+    
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+    std::atomic<uint64_t> inserts_;
+    std::atomic<uint64_t> evictions_;
+    
+public:
+    QValueCache() : QValueCache(Config()) {}
+    explicit QValueCache(const Config& config);
+    
+    Key makeKey(const Eigen::VectorXd& state) const;
+    
+    // Fills q_values and returns true on a hit computed under `version`
+    bool lookup(const Key& key, uint64_t version, Eigen::VectorXd& q_values);
+    void insert(const Key& key, uint64_t version, const Eigen::VectorXd& q_values);
+    
+    void clear();
+    Stats getStats() const;
+    void resetStats();
+    const Config& getConfig() const { return config_; }
+    size_t capacity() const { return shards_.size() * (slot_mask_ + 1); }
+};
+
+} // namespace MusicAI
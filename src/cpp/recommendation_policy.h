@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Eigen/Core>
+#include <vector>
+
+namespace MusicAI {
+
+// Serving interface shared by the DQN engine and the lightweight bandit
+// policies, so the policy behind a listener can be swapped (e.g. a bandit
+// for cold users, the DQN once they have history). States are the 8
+// features of MusicEnvironment::stateToVector; actions are genres.
+class RecommendationPolicy {
+public:
+    virtual ~RecommendationPolicy() = default;
+    
+    virtual int predict(const std::vector<double>& state) = 0;
+    virtual void train(const std::vector<double>& state,
+                       int action,
+                       double reward,
+                       const std::vector<double>& next_state,
+                       bool done) = 0;
+    
+    // One state per column
+    virtual std::vector<int> predictBatch(const Eigen::MatrixXd& states, unsigned num_threads = 1) = 0;
+    virtual void trainBatch(const Eigen::MatrixXd& states,
+                            const std::vector<int>& actions,
+                            const std::vector<double>& rewards,
+                            const Eigen::MatrixXd& next_states,
+                            const std::vector<bool>& dones) = 0;
+    
+    // Per-action scores greedy selection ranks (Q-values for the DQN)
+    virtual std::vector<double> getQValues(const std::vector<double>& state) const = 0;
+};
+
+} // namespace MusicAI
@@ -0,0 +1,75 @@
+#include "session_tracker.h"
+
+namespace MusicAI {
+
+SessionTracker::SessionTracker(const Config& config) : config_(config) {
+    sessions_.reserve(config_.expected_sessions);
+}
+
+void SessionTracker::observe(uint64_t session_id, const Eigen::VectorXd& state, int action,
+                             double reward, double timestamp, std::vector<Experience>& out) {
+    auto inserted = sessions_.try_emplace(session_id);
+    Session& session = inserted.first->second;
+    
+    if (!inserted.second) {
+        bool timed_out = config_.idle_timeout_seconds > 0.0 &&
+                         timestamp - session.last_seen > config_.idle_timeout_seconds;
+        bool episode_full = config_.max_episode_length > 0 &&
+                            session.episode_step >= config_.max_episode_length;
+        
+        if (timed_out) {
+            // The listener left; the pending event has no real successor
+            out.emplace_back(session.state, session.action, session.reward, session.state, true);
+            session.episode_step = 0;
+        } else {
+            out.emplace_back(session.state, session.action, session.reward, state, episode_full);
+            if (episode_full) {
+                session.episode_step = 0;
+            }
+        }
+    } else {
+        session.episode_step = 0;
+    }
+    
+    session.state = state;
+    session.action = action;
+    session.reward = reward;
+    session.last_seen = timestamp;
+    ++session.episode_step;
+}
+
+bool SessionTracker::endSession(uint64_t session_id, std::vector<Experience>& out) {
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+        return false;
+    }
+    
+    const Session& session = it->second;
+    out.emplace_back(session.state, session.action, session.reward, session.state, true);
+    sessions_.erase(it);
+    return true;
+}
+
+std::vector<uint64_t> SessionTracker::idleSessions(double now) const {
+    std::vector<uint64_t> idle;
+    if (config_.idle_timeout_seconds <= 0.0) {
+        return idle;
+    }
+    for (const auto& entry : sessions_) {
+        if (now - entry.second.last_seen > config_.idle_timeout_seconds) {
+            idle.push_back(entry.first);
+        }
+    }
+    return idle;
+}
+
+std::vector<uint64_t> SessionTracker::sessionIds() const {
+    std::vector<uint64_t> ids;
+    ids.reserve(sessions_.size());
+    for (const auto& entry : sessions_) {
+        ids.push_back(entry.first);
+    }
+    return ids;
+}
+
+} // namespace MusicAI
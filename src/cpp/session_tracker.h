@@ -0,0 +1,54 @@
+#pragma once
+
+#include "experience_buffer.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+// Turns a stream of per-listener feedback events (state, action, reward) into
+// proper (s, a, r, s', done) transitions. Each session keeps its last event
+// pending until the next one arrives and supplies s'. O(1) per event.
+class SessionTracker {
+public:
+    struct Config {
+        int max_episode_length = 50;          // Events per episode; 0 = unbounded
+        double idle_timeout_seconds = 1800.0; // Gap that ends an episode; <= 0 disables
+        size_t expected_sessions = 1024;      // Initial hash table capacity
+    };
+    
+private:
+    struct Session {
+        Eigen::VectorXd state;
+        int action;
+        double reward;
+        double last_seen;
+        int episode_step;
+    };
+    
+    Config config_;
+    std::unordered_map<uint64_t, Session> sessions_;
+    
+public:
+    SessionTracker() : SessionTracker(Config()) {}
+    explicit SessionTracker(const Config& config);
+    
+    // Records an event and appends any completed transitions to `out`
+    void observe(uint64_t session_id, const Eigen::VectorXd& state, int action,
+                 double reward, double timestamp, std::vector<Experience>& out);
+    
+    // Emits the pending event of a session as terminal and forgets the session
+    bool endSession(uint64_t session_id, std::vector<Experience>& out);
+    
+    // Sessions idle since before now - idle_timeout_seconds; end them with endSession
+    std::vector<uint64_t> idleSessions(double now) const;
+    std::vector<uint64_t> sessionIds() const;
+    
+    size_t activeSessions() const { return sessions_.size(); }
+    const Config& getConfig() const { return config_; }
+    void clear() { sessions_.clear(); }
+};
+
+} // namespace MusicAI
@@ -0,0 +1,95 @@
+#include "sparse_feature_network.h"
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+NeuralNetwork::Architecture networkArchitecture(const SparseFeatureNetwork::Config& config,
+                                                const std::vector<SparseFeatureNetwork::Field>& fields) {
+    NeuralNetwork::Architecture architecture;
+    architecture.input_size = NeuralNetwork::INPUT_SIZE;
+    for (const auto& field : fields) {
+        architecture.input_size += field.table.dim;
+    }
+    architecture.hidden_sizes = config.hidden_sizes;
+    architecture.head = config.head;
+    return architecture;
+}
+
+std::vector<SparseFeatureNetwork::Field> resolveFields(const SparseFeatureNetwork::Config& config) {
+    return config.fields.empty() ? SparseFeatureNetwork::defaultFields() : config.fields;
+}
+
+} // namespace
+
+std::vector<SparseFeatureNetwork::Field> SparseFeatureNetwork::defaultFields() {
+    // A listener's own vector, plus mean-pooled recent tracks and artists.
+    // Separate seeds keep the fields' hash functions independent.
+    std::vector<Field> fields(3);
+    fields[0].name = "user";
+    fields[0].table.buckets = 1 << 18;
+    fields[0].table.pooling = HashedEmbeddingTable::Pooling::SUM;
+    fields[0].table.seed = 1;
+    fields[1].name = "tracks";
+    fields[1].table.buckets = 1 << 20;
+    fields[1].table.seed = 2;
+    fields[2].name = "artists";
+    fields[2].table.buckets = 1 << 16;
+    fields[2].table.seed = 3;
+    return fields;
+}
+
+SparseFeatureNetwork::SparseFeatureNetwork(const Config& config)
+    : network_(networkArchitecture(config, resolveFields(config)), config.learning_rate) {
+    for (const Field& field : resolveFields(config)) {
+        field_names_.push_back(field.name);
+        tables_.emplace_back(field.table);
+    }
+}
+
+Eigen::MatrixXd SparseFeatureNetwork::buildInputs(const Eigen::MatrixXd& states, const SparseBatch& sparse) const {
+    if (states.rows() != NeuralNetwork::INPUT_SIZE || sparse.size() != tables_.size()) {
+        throw std::invalid_argument("Need the state features and one bag list per field");
+    }
+    
+    Eigen::MatrixXd inputs(network_.getInputSize(), states.cols());
+    inputs.topRows(NeuralNetwork::INPUT_SIZE) = states;
+    Eigen::Index row = NeuralNetwork::INPUT_SIZE;
+    for (size_t f = 0; f < tables_.size(); ++f) {
+        if (sparse[f].size() != static_cast<size_t>(states.cols())) {
+            throw std::invalid_argument("Need one bag per sample for field " + field_names_[f]);
+        }
+        tables_[f].pool(sparse[f], inputs.middleRows(row, tables_[f].dim()));
+        row += tables_[f].dim();
+    }
+    return inputs;
+}
+
+Eigen::MatrixXd SparseFeatureNetwork::forwardBatch(const Eigen::MatrixXd& states, const SparseBatch& sparse,
+                                                   unsigned num_threads) const {
+    return network_.forwardBatch(buildInputs(states, sparse), num_threads);
+}
+
+Eigen::MatrixXd SparseFeatureNetwork::bellmanTargets(const Eigen::MatrixXd& next_states,
+                                                     const SparseBatch& next_sparse,
+                                                     const std::vector<int>& next_actions,
+                                                     const Eigen::VectorXd& rewards,
+                                                     const Eigen::VectorXd& discounts) const {
+    return network_.bellmanTargets(buildInputs(next_states, next_sparse), next_actions, rewards, discounts);
+}
+
+double SparseFeatureNetwork::trainBatch(const Eigen::MatrixXd& states, const SparseBatch& sparse,
+                                        const std::vector<int>& actions, const Eigen::MatrixXd& targets) {
+    Eigen::MatrixXd input_gradient;
+    double loss = network_.trainBatch(buildInputs(states, sparse), actions, targets, &input_gradient);
+    
+    Eigen::Index row = NeuralNetwork::INPUT_SIZE;
+    for (size_t f = 0; f < tables_.size(); ++f) {
+        tables_[f].update(sparse[f], input_gradient.middleRows(row, tables_[f].dim()));
+        row += tables_[f].dim();
+    }
+    return loss;
+}
+
+} // namespace MusicAI
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "neural_network.h"
+#include "hashed_embedding.h"
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+namespace MusicAI {
+
+// Q-network over the dense state plus pooled embeddings of categorical
+// fields. Each field's bag of IDs is pooled by its own hashed table and the
+// results are concatenated below the 8 state features; the network sees one
+// wider input. Training steps the network densely and each table sparsely
+// from the network's input gradient.
+class SparseFeatureNetwork {
+public:
+    struct Field {
+        std::string name;
+        HashedEmbeddingTable::Config table;
+    };
+    
+    struct Config {
+        std::vector<Field> fields;  // Empty = user, recent tracks and artists (defaultFields)
+        std::vector<int> hidden_sizes = {64, 32, 16};
+        HeadConfig head;
+        double learning_rate = 0.001;  // Network SGD; tables use their own Adam rate
+    };
+    
+    // Categorical inputs: one bag of IDs per field and sample ([field][sample])
+    using SparseBatch = std::vector<std::vector<HashedEmbeddingTable::Bag>>;
+    
+    static std::vector<Field> defaultFields();
+    
+private:
+    std::vector<std::string> field_names_;
+    std::vector<HashedEmbeddingTable> tables_;
+    NeuralNetwork network_;
+    
+public:
+    SparseFeatureNetwork() : SparseFeatureNetwork(Config()) {}
+    explicit SparseFeatureNetwork(const Config& config);
+    
+    // Dense states (8 x batch) stacked over the pooled field embeddings
+    Eigen::MatrixXd buildInputs(const Eigen::MatrixXd& states, const SparseBatch& sparse) const;
+    
+    Eigen::MatrixXd forwardBatch(const Eigen::MatrixXd& states, const SparseBatch& sparse,
+                                 unsigned num_threads = 1) const;
+    
+    // Same contract as NeuralNetwork::bellmanTargets/trainBatch
+    Eigen::MatrixXd bellmanTargets(const Eigen::MatrixXd& next_states, const SparseBatch& next_sparse,
+                                   const std::vector<int>& next_actions,
+                                   const Eigen::VectorXd& rewards,
+                                   const Eigen::VectorXd& discounts) const;
+    double trainBatch(const Eigen::MatrixXd& states, const SparseBatch& sparse,
+                      const std::vector<int>& actions, const Eigen::MatrixXd& targets);
+    
+    size_t numFields() const { return tables_.size(); }
+    const std::string& getFieldName(size_t field) const { return field_names_.at(field); }
+    const HashedEmbeddingTable& getTable(size_t field) const { return tables_.at(field); }
+    const NeuralNetwork& getNetwork() const { return network_; }
+};
+
+} // namespace MusicAI
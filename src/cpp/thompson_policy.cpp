@@ -0,0 +1,143 @@
+#include "thompson_policy.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+void fillStandardNormal(FastRng& rng, double* out, size_t n) {
+    // Single precision is plenty for sampling noise and keeps log/sin/cos
+    // on Eigen's packet paths
+    constexpr float TWO_PI = 6.2831853f;
+    const Eigen::Index pairs = static_cast<Eigen::Index>(n / 2);
+    Eigen::ArrayXf radius(pairs);
+    Eigen::ArrayXf angle(pairs);
+    for (Eigen::Index i = 0; i < pairs; ++i) {
+        uint64_t bits = rng();
+        // Two 24-bit uniforms per draw; the radius one is in (0, 1] so log stays finite
+        radius(i) = static_cast<float>(static_cast<int32_t>(bits >> 40) + 1) * 0x1.0p-24f;
+        angle(i) = static_cast<float>(static_cast<int32_t>(bits & 0xFFFFFF)) * (TWO_PI * 0x1.0p-24f);
+    }
+    radius = (-2.0f * radius.log()).sqrt();
+    Eigen::ArrayXf normals(2 * pairs);
+    normals.head(pairs) = radius * angle.cos();
+    normals.tail(pairs) = radius * angle.sin();
+    Eigen::Map<Eigen::ArrayXd>(out, 2 * pairs) = normals.cast<double>();
+    if (n % 2 != 0) {
+        out[n - 1] = std::sqrt(-2.0 * std::log(1.0 - rng.uniform())) * std::cos(static_cast<double>(TWO_PI) * rng.uniform());
+    }
+}
+
+ThompsonSamplingPolicy::ThompsonSamplingPolicy(const Config& config) : config_(config), rng_(config.seed) {
+    if (!(config_.regularization > 0.0) || !(config_.noise_scale >= 0.0)) {
+        throw std::invalid_argument("Thompson sampling needs positive regularization and non-negative noise scale");
+    }
+    reset();
+}
+
+void ThompsonSamplingPolicy::reset() {
+    const Precision prior = config_.regularization * Precision::Identity();
+    for (auto& factor : factors_) {
+        factor.compute(prior);
+    }
+    rewards_.setZero();
+    means_.setZero();
+    pulls_.fill(0);
+}
+
+void ThompsonSamplingPolicy::update(const Features& features, int arm, double reward) {
+    if (arm < 0 || arm >= NUM_ARMS) {
+        throw std::out_of_range("Action out of range");
+    }
+    // B_k += x x^T as a rank-one update of the cached factor, then two O(d^2) solves
+    factors_[arm].rankUpdate(features, 1.0);
+    rewards_.col(arm) += reward * features;
+    means_.col(arm) = factors_[arm].solve(rewards_.col(arm));
+    ++pulls_[arm];
+}
+
+Eigen::MatrixXd ThompsonSamplingPolicy::sampleScores(const Eigen::MatrixXd& states) {
+    if (states.rows() != CONTEXT_SIZE) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    const Eigen::Index n = states.cols();
+    Eigen::Matrix<double, FEATURES, Eigen::Dynamic> features(FEATURES, n);
+    features.topRows<CONTEXT_SIZE>() = states;
+    features.row(CONTEXT_SIZE).setOnes();
+    
+    normals_.resize(FEATURES, NUM_ARMS * n);
+    fillStandardNormal(rng_, normals_.data(), static_cast<size_t>(normals_.size()));
+    
+    // theta = mu + v L^-T z, so score = mu . x + v (L^-T z) . x
+    Eigen::MatrixXd scores = means_.transpose() * features;
+    for (int arm = 0; arm < NUM_ARMS; ++arm) {
+        auto deviations = normals_.middleCols(arm * n, n);
+        factors_[arm].matrixU().solveInPlace(deviations);
+        scores.row(arm) += config_.noise_scale * deviations.cwiseProduct(features).colwise().sum();
+    }
+    return scores;
+}
+
+int ThompsonSamplingPolicy::predict(const std::vector<double>& state) {
+    if (state.size() != static_cast<size_t>(CONTEXT_SIZE)) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    Eigen::Index best;
+    sampleScores(Eigen::Map<const Eigen::MatrixXd>(state.data(), CONTEXT_SIZE, 1)).col(0).maxCoeff(&best);
+    return static_cast<int>(best);
+}
+
+void ThompsonSamplingPolicy::train(const std::vector<double>& state,
+                                   int action,
+                                   double reward,
+                                   const std::vector<double>& next_state,
+                                   bool done) {
+    (void)next_state;
+    (void)done;
+    if (state.size() != static_cast<size_t>(CONTEXT_SIZE)) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    Features features;
+    features << Eigen::Map<const Eigen::Matrix<double, CONTEXT_SIZE, 1>>(state.data()), 1.0;
+    update(features, action, reward);
+}
+
+std::vector<int> ThompsonSamplingPolicy::predictBatch(const Eigen::MatrixXd& states, unsigned num_threads) {
+    (void)num_threads;
+    Eigen::MatrixXd scores = sampleScores(states);
+    std::vector<int> actions(scores.cols());
+    for (Eigen::Index j = 0; j < scores.cols(); ++j) {
+        Eigen::Index best;
+        scores.col(j).maxCoeff(&best);
+        actions[j] = static_cast<int>(best);
+    }
+    return actions;
+}
+
+void ThompsonSamplingPolicy::trainBatch(const Eigen::MatrixXd& states,
+                                        const std::vector<int>& actions,
+                                        const std::vector<double>& rewards,
+                                        const Eigen::MatrixXd& next_states,
+                                        const std::vector<bool>& dones) {
+    (void)next_states;
+    size_t n = static_cast<size_t>(states.cols());
+    if (states.rows() != CONTEXT_SIZE || actions.size() != n || rewards.size() != n || dones.size() != n) {
+        throw std::invalid_argument("Batch size mismatch");
+    }
+    for (size_t i = 0; i < n; ++i) {
+        Features features;
+        features << states.col(i), 1.0;
+        update(features, actions[i], rewards[i]);
+    }
+}
+
+std::vector<double> ThompsonSamplingPolicy::getQValues(const std::vector<double>& state) const {
+    if (state.size() != static_cast<size_t>(CONTEXT_SIZE)) {
+        throw std::invalid_argument("State size mismatch");
+    }
+    Features features;
+    features << Eigen::Map<const Eigen::Matrix<double, CONTEXT_SIZE, 1>>(state.data()), 1.0;
+    Eigen::Matrix<double, NUM_ARMS, 1> scores = means_.transpose() * features;
+    return std::vector<double>(scores.data(), scores.data() + NUM_ARMS);
+}
+
+} // namespace MusicAI
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "neural_network.h"
+#include "recommendation_policy.h"
+#include "fast_rng.h"
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+#include <array>
+#include <cstdint>
+
+namespace MusicAI {
+
+// Linear Thompson sampling (Agrawal & Goyal): each genre keeps a Gaussian
+// posterior over weights for the session features plus a bias feature,
+// N(mu_k, v^2 B_k^-1) with B_k = lambda I + sum x x^T. The Cholesky factor
+// of B_k is cached and updated with an O(d^2) rank-one update per feedback
+// event. A decision draws one weight sample per arm, theta = mu + v L^-T z,
+// and picks the arm with the highest sampled score. Batches fill one block
+// of standard normals from the policy's FastRng (vectorized Box-Muller) and
+// solve every request of an arm against the factor at once.
+class ThompsonSamplingPolicy : public RecommendationPolicy {
+public:
+    static constexpr int CONTEXT_SIZE = NeuralNetwork::INPUT_SIZE;
+    static constexpr int FEATURES = CONTEXT_SIZE + 1;
+    static constexpr int NUM_ARMS = NeuralNetwork::OUTPUT_SIZE;
+    static constexpr uint64_t DEFAULT_SEED = 42;
+    using Features = Eigen::Matrix<double, FEATURES, 1>;
+    using Precision = Eigen::Matrix<double, FEATURES, FEATURES>;
+    
+    struct Config {
+        double regularization = 1.0;  // Prior precision lambda
+        double noise_scale = 0.5;     // v: posterior width multiplier
+        uint64_t seed = DEFAULT_SEED;
+    };
+    
+private:
+    Config config_;
+    std::array<Eigen::LLT<Precision>, NUM_ARMS> factors_;  // Cholesky of each B_k
+    Eigen::Matrix<double, FEATURES, NUM_ARMS> rewards_;    // sum r x per arm
+    Eigen::Matrix<double, FEATURES, NUM_ARMS> means_;      // B_k^-1 rewards_k
+    std::array<uint64_t, NUM_ARMS> pulls_;
+    FastRng rng_;
+    Eigen::MatrixXd normals_;                              // Scratch: FEATURES x (arms * batch)
+    
+public:
+    ThompsonSamplingPolicy() : ThompsonSamplingPolicy(Config()) {}
+    explicit ThompsonSamplingPolicy(const Config& config);
+    
+    // RecommendationPolicy. Bandit updates ignore next_state and done, and
+    // batches are a few small products, so num_threads is unused.
+    int predict(const std::vector<double>& state) override;
+    void train(const std::vector<double>& state,
+               int action,
+               double reward,
+               const std::vector<double>& next_state,
+               bool done) override;
+    std::vector<int> predictBatch(const Eigen::MatrixXd& states, unsigned num_threads = 1) override;
+    void trainBatch(const Eigen::MatrixXd& states,
+                    const std::vector<int>& actions,
+                    const std::vector<double>& rewards,
+                    const Eigen::MatrixXd& next_states,
+                    const std::vector<bool>& dones) override;
+    // Posterior mean scores (no sampling)
+    std::vector<double> getQValues(const std::vector<double>& state) const override;
+    
+    // One posterior sample per arm and state: sampled scores (NUM_ARMS x n)
+    Eigen::MatrixXd sampleScores(const Eigen::MatrixXd& states);
+    void update(const Features& features, int arm, double reward);
+    void reset();
+    
+    void setSeed(uint64_t seed) { rng_.seed(seed); }
+    const Eigen::Matrix<double, FEATURES, NUM_ARMS>& getMeans() const { return means_; }
+    uint64_t getPulls(int arm) const { return pulls_[arm]; }
+    const Config& getConfig() const { return config_; }
+};
+
+// Fills out[0, n) with independent standard normal draws: uniforms from
+// rng, then Box-Muller over the whole block in single precision with
+// Eigen array math (packet log/sqrt/sin/cos)
+void fillStandardNormal(FastRng& rng, double* out, size_t n);
+
+} // namespace MusicAI
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace MusicAI {
+
+// Dense bitset over track IDs, the result type of catalog filter scans.
+// Filters combine with &= / |= a word at a time; bits past size() are
+// always zero so count() and forEach() need no tail masking.
+class TrackBitmap {
+private:
+    std::vector<uint64_t> words_;
+    size_t size_;
+    
+public:
+    explicit TrackBitmap(size_t size = 0) : words_((size + 63) / 64, 0), size_(size) {}
+    
+    size_t size() const { return size_; }
+    size_t numWords() const { return words_.size(); }
+    uint64_t* words() { return words_.data(); }
+    const uint64_t* words() const { return words_.data(); }
+    
+    bool test(size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+    void set(size_t i) { words_[i >> 6] |= uint64_t(1) << (i & 63); }
+    void reset(size_t i) { words_[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    
+    void setAll() {
+        std::fill(words_.begin(), words_.end(), ~uint64_t(0));
+        clearTail();
+    }
+    
+    size_t count() const {
+        size_t total = 0;
+        for (uint64_t word : words_) {
+            total += static_cast<size_t>(__builtin_popcountll(word));
+        }
+        return total;
+    }
+    
+    TrackBitmap& operator&=(const TrackBitmap& other) {
+        checkSize(other);
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] &= other.words_[w];
+        }
+        return *this;
+    }
+    
+    TrackBitmap& operator|=(const TrackBitmap& other) {
+        checkSize(other);
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] |= other.words_[w];
+        }
+        return *this;
+    }
+    
+    // Calls fn(track) for each set bit in increasing order
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t w = 0; w < words_.size(); ++w) {
+            for (uint64_t word = words_[w]; word != 0; word &= word - 1) {
+                fn(static_cast<uint32_t>(w * 64 + static_cast<size_t>(__builtin_ctzll(word))));
+            }
+        }
+    }
+    
+    std::vector<uint32_t> toIndices() const {
+        std::vector<uint32_t> indices;
+        indices.reserve(count());
+        forEach([&indices](uint32_t track) { indices.push_back(track); });
+        return indices;
+    }
+    
+    // Zeroes bits past size() after a scan wrote whole words
+    void clearTail() {
+        if (size_ % 64 != 0) {
+            words_.back() &= (uint64_t(1) << (size_ % 64)) - 1;
+        }
+    }
+    
+private:
+    void checkSize(const TrackBitmap& other) const {
+        if (other.size_ != size_) {
+            throw std::invalid_argument("Bitmap size mismatch");
+        }
+    }
+};
+
+} // namespace MusicAI
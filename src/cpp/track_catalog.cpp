@@ -0,0 +1,283 @@
+#include "track_catalog.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace MusicAI {
+
+namespace {
+
+// Catalog files: a fixed header, the genre dictionary (uint32 length plus
+// bytes per name), then the genre, float and embedding columns, each at a
+// 64-byte aligned offset recorded in the header
+constexpr uint32_t CATALOG_MAGIC = 0x4354514D;  // "MQTC"
+constexpr uint32_t CATALOG_VERSION = 1;
+constexpr size_t COLUMN_ALIGNMENT = 64;
+constexpr uint32_t MAX_EMBEDDING_DIM = 1 << 16;
+
+struct CatalogHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t embedding_dim;
+    uint32_t num_genres;
+    uint64_t num_tracks;
+    uint64_t genre_offset;
+    uint64_t column_offsets[TrackCatalog::NUM_FLOAT_COLUMNS];
+    uint64_t embedding_offset;
+    uint64_t file_size;
+};
+
+// Whether count elements of elem_size bytes starting at offset end within
+// limit, without forming offset + count * elem_size (both come from the file)
+bool fitsIn(uint64_t offset, uint64_t count, uint64_t elem_size, uint64_t limit) {
+    return offset <= limit && (elem_size == 0 || count <= (limit - offset) / elem_size);
+}
+
+size_t alignColumn(size_t offset) {
+    return (offset + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+}
+
+void writeAt(std::ofstream& file, size_t& position, size_t offset, const void* data, size_t bytes) {
+    static const char padding[COLUMN_ALIGNMENT] = {};
+    file.write(padding, static_cast<std::streamsize>(offset - position));
+    file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    position = offset + bytes;
+}
+
+} // namespace
+
+TrackCatalog::Builder::Builder(int embedding_dim) : embedding_dim_(embedding_dim) {
+    if (embedding_dim < 0) {
+        throw std::invalid_argument("Embedding dimension must be non-negative");
+    }
+}
+
+void TrackCatalog::Builder::add(const std::string& genre, float tempo, float energy, float valence,
+                                const float* embedding) {
+    auto it = genre_codes_.find(genre);
+    if (it == genre_codes_.end()) {
+        if (genre_names_.size() == MAX_GENRES) {
+            throw std::length_error("Catalog supports at most 256 genres");
+        }
+        it = genre_codes_.emplace(genre, static_cast<uint8_t>(genre_names_.size())).first;
+        genre_names_.push_back(genre);
+    }
+    genres_.push_back(it->second);
+    columns_[static_cast<int>(Column::TEMPO)].push_back(tempo);
+    columns_[static_cast<int>(Column::ENERGY)].push_back(energy);
+    columns_[static_cast<int>(Column::VALENCE)].push_back(valence);
+    embeddings_.insert(embeddings_.end(), embedding, embedding + embedding_dim_);
+}
+
+void TrackCatalog::Builder::write(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filename);
+    }
+    
+    CatalogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = CATALOG_MAGIC;
+    header.version = CATALOG_VERSION;
+    header.embedding_dim = static_cast<uint32_t>(embedding_dim_);
+    header.num_genres = static_cast<uint32_t>(genre_names_.size());
+    header.num_tracks = genres_.size();
+    
+    size_t offset = sizeof(CatalogHeader);
+    for (const std::string& name : genre_names_) {
+        offset += sizeof(uint32_t) + name.size();
+    }
+    header.genre_offset = alignColumn(offset);
+    offset = header.genre_offset + genres_.size();
+    for (int c = 0; c < NUM_FLOAT_COLUMNS; ++c) {
+        header.column_offsets[c] = alignColumn(offset);
+        offset = header.column_offsets[c] + columns_[c].size() * sizeof(float);
+    }
+    header.embedding_offset = alignColumn(offset);
+    header.file_size = header.embedding_offset + embeddings_.size() * sizeof(float);
+    
+    size_t position = 0;
+    writeAt(file, position, 0, &header, sizeof(header));
+    for (const std::string& name : genre_names_) {
+        uint32_t length = static_cast<uint32_t>(name.size());
+        writeAt(file, position, position, &length, sizeof(length));
+        writeAt(file, position, position, name.data(), name.size());
+    }
+    writeAt(file, position, header.genre_offset, genres_.data(), genres_.size());
+    for (int c = 0; c < NUM_FLOAT_COLUMNS; ++c) {
+        writeAt(file, position, header.column_offsets[c], columns_[c].data(), columns_[c].size() * sizeof(float));
+    }
+    writeAt(file, position, header.embedding_offset, embeddings_.data(), embeddings_.size() * sizeof(float));
+    if (!file) {
+        throw std::runtime_error("Failed to write track catalog: " + filename);
+    }
+}
+
+TrackCatalog::TrackCatalog()
+    : num_tracks_(0), embedding_dim_(0), genres_(nullptr), columns_{}, embeddings_(nullptr) {}
+
+TrackCatalog TrackCatalog::open(const std::string& filename) {
+    MappedFile file = MappedFile::open(filename);
+    const size_t file_size = file.size;
+    
+    const char* bytes = static_cast<const char*>(file.data.get());
+    if (file_size < sizeof(CatalogHeader)) {
+        throw std::runtime_error("Truncated track catalog: " + filename);
+    }
+    CatalogHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.magic != CATALOG_MAGIC || header.version != CATALOG_VERSION) {
+        throw std::runtime_error("Not a compatible track catalog: " + filename);
+    }
+    if (header.num_genres > MAX_GENRES || header.embedding_dim > MAX_EMBEDDING_DIM ||
+        header.num_tracks > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Not a compatible track catalog: " + filename);
+    }
+    if (header.file_size > file_size ||
+        !fitsIn(header.genre_offset, header.num_tracks, 1, header.file_size) ||
+        !fitsIn(header.embedding_offset, header.num_tracks,
+                uint64_t{header.embedding_dim} * sizeof(float), header.file_size)) {
+        throw std::runtime_error("Truncated track catalog: " + filename);
+    }
+    
+    TrackCatalog catalog;
+    catalog.num_tracks_ = header.num_tracks;
+    catalog.embedding_dim_ = static_cast<int>(header.embedding_dim);
+    size_t offset = sizeof(CatalogHeader);
+    for (uint32_t g = 0; g < header.num_genres; ++g) {
+        uint32_t length;
+        if (offset + sizeof(length) > header.genre_offset) {
+            throw std::runtime_error("Corrupt genre dictionary: " + filename);
+        }
+        std::memcpy(&length, bytes + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > header.genre_offset) {
+            throw std::runtime_error("Corrupt genre dictionary: " + filename);
+        }
+        catalog.genre_names_.emplace_back(bytes + offset, length);
+        offset += length;
+    }
+    
+    catalog.genres_ = reinterpret_cast<const uint8_t*>(bytes + header.genre_offset);
+    // Codes index the genre dictionary here and in PlaylistBuilder, so check
+    // them once rather than on every lookup
+    uint8_t max_code = 0;
+    for (size_t i = 0; i < catalog.num_tracks_; ++i) {
+        max_code = std::max(max_code, catalog.genres_[i]);
+    }
+    if (catalog.num_tracks_ > 0 && max_code >= header.num_genres) {
+        throw std::runtime_error("Genre code outside the dictionary: " + filename);
+    }
+    for (int c = 0; c < NUM_FLOAT_COLUMNS; ++c) {
+        if (header.column_offsets[c] % alignof(float) != 0 ||
+            !fitsIn(header.column_offsets[c], header.num_tracks, sizeof(float), header.file_size)) {
+            throw std::runtime_error("Truncated track catalog: " + filename);
+        }
+        catalog.columns_[c] = reinterpret_cast<const float*>(bytes + header.column_offsets[c]);
+    }
+    if (header.embedding_offset % alignof(float) != 0) {
+        throw std::runtime_error("Truncated track catalog: " + filename);
+    }
+    catalog.embeddings_ = reinterpret_cast<const float*>(bytes + header.embedding_offset);
+    catalog.mapping_ = std::move(file.data);
+    return catalog;
+}
+
+int TrackCatalog::genreCode(const std::string& name) const {
+    for (size_t g = 0; g < genre_names_.size(); ++g) {
+        if (genre_names_[g] == name) {
+            return static_cast<int>(g);
+        }
+    }
+    return -1;
+}
+
+TrackBitmap TrackCatalog::filterGenre(const std::string& name) const {
+    return filterGenre(genreCode(name));
+}
+
+TrackBitmap TrackCatalog::filterGenre(int code) const {
+    TrackBitmap result(num_tracks_);
+    if (code < 0 || code >= static_cast<int>(genre_names_.size())) {
+        return result;
+    }
+    const uint8_t target = static_cast<uint8_t>(code);
+    uint64_t* words = result.words();
+    const size_t full_words = num_tracks_ / 64;
+    
+#ifdef __SSE2__
+    // 64 codes per output word: four 16-byte compares, one movemask each
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(target));
+    for (size_t w = 0; w < full_words; ++w) {
+        const uint8_t* codes = genres_ + w * 64;
+        uint64_t word = 0;
+        for (int part = 0; part < 4; ++part) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + part * 16));
+            uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+            word |= static_cast<uint64_t>(mask) << (part * 16);
+        }
+        words[w] = word;
+    }
+#else
+    for (size_t w = 0; w < full_words; ++w) {
+        uint64_t word = 0;
+        for (int bit = 0; bit < 64; ++bit) {
+            word |= static_cast<uint64_t>(genres_[w * 64 + bit] == target) << bit;
+        }
+        words[w] = word;
+    }
+#endif
+    for (size_t i = full_words * 64; i < num_tracks_; ++i) {
+        if (genres_[i] == target) {
+            result.set(i);
+        }
+    }
+    return result;
+}
+
+TrackBitmap TrackCatalog::filterRange(Column column, float lo, float hi) const {
+    TrackBitmap result(num_tracks_);
+    const float* values = columns_[static_cast<int>(column)];
+    uint64_t* words = result.words();
+    const size_t full_words = num_tracks_ / 64;
+    
+#ifdef __SSE2__
+    // 64 values per output word: sixteen 4-wide compare pairs (NaN fails both)
+    const __m128 low = _mm_set1_ps(lo);
+    const __m128 high = _mm_set1_ps(hi);
+    for (size_t w = 0; w < full_words; ++w) {
+        const float* block = values + w * 64;
+        uint64_t word = 0;
+        for (int part = 0; part < 16; ++part) {
+            __m128 v = _mm_loadu_ps(block + part * 4);
+            __m128 inside = _mm_and_ps(_mm_cmpge_ps(v, low), _mm_cmple_ps(v, high));
+            word |= static_cast<uint64_t>(_mm_movemask_ps(inside)) << (part * 4);
+        }
+        words[w] = word;
+    }
+#else
+    for (size_t w = 0; w < full_words; ++w) {
+        uint64_t word = 0;
+        for (int bit = 0; bit < 64; ++bit) {
+            float v = values[w * 64 + bit];
+            word |= static_cast<uint64_t>(v >= lo && v <= hi) << bit;
+        }
+        words[w] = word;
+    }
+#endif
+    for (size_t i = full_words * 64; i < num_tracks_; ++i) {
+        if (values[i] >= lo && values[i] <= hi) {
+            result.set(i);
+        }
+    }
+    return result;
+}
+
+} // namespace MusicAI
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "track_bitmap.h"
+#include <Eigen/Core>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MusicAI {
+
+// Columnar track catalog stored in one file and memory-mapped read-only:
+// a dictionary-encoded genre column (one uint8 code per track), float
+// tempo / energy / valence columns, and float embeddings (dim x tracks,
+// column-major). Each column starts on a 64-byte boundary, so filter scans
+// stream straight over the mapping with SIMD compares and emit a
+// TrackBitmap; nothing is materialized per track.
+class TrackCatalog {
+public:
+    enum class Column {
+        TEMPO,
+        ENERGY,
+        VALENCE
+    };
+    static constexpr int NUM_FLOAT_COLUMNS = 3;
+    static constexpr int MAX_GENRES = 256;
+    
+    // Accumulates tracks in memory and writes a catalog file
+    class Builder {
+    private:
+        int embedding_dim_;
+        std::vector<std::string> genre_names_;
+        std::unordered_map<std::string, uint8_t> genre_codes_;
+        std::vector<uint8_t> genres_;
+        std::vector<float> columns_[NUM_FLOAT_COLUMNS];
+        std::vector<float> embeddings_;
+        
+    public:
+        explicit Builder(int embedding_dim);
+        
+        // embedding points at embedding_dim floats
+        void add(const std::string& genre, float tempo, float energy, float valence, const float* embedding);
+        size_t size() const { return genres_.size(); }
+        void write(const std::string& filename) const;
+    };
+    
+private:
+    std::shared_ptr<const void> mapping_;
+    size_t num_tracks_;
+    int embedding_dim_;
+    std::vector<std::string> genre_names_;
+    const uint8_t* genres_;
+    const float* columns_[NUM_FLOAT_COLUMNS];
+    const float* embeddings_;
+    
+    TrackCatalog();
+    
+public:
+    TrackCatalog(TrackCatalog&&) = default;
+    TrackCatalog& operator=(TrackCatalog&&) = default;
+    TrackCatalog(const TrackCatalog&) = delete;
+    TrackCatalog& operator=(const TrackCatalog&) = delete;
+    
+    // Maps the file read-only (copies it where mmap is unavailable)
+    static TrackCatalog open(const std::string& filename);
+    
+    size_t size() const { return num_tracks_; }
+    int embeddingDim() const { return embedding_dim_; }
+    
+    // Genre dictionary; codes index genreNames()
+    const std::vector<std::string>& genreNames() const { return genre_names_; }
+    int genreCode(const std::string& name) const;  // -1 when absent
+    const uint8_t* genreCodes() const { return genres_; }  // Each < genreNames().size()
+    const float* column(Column column) const { return columns_[static_cast<int>(column)]; }
+    Eigen::Map<const Eigen::MatrixXf> embeddings() const {
+        return Eigen::Map<const Eigen::MatrixXf>(embeddings_, embedding_dim_, static_cast<Eigen::Index>(num_tracks_));
+    }
+    
+    // Filter scans over the whole catalog
+    TrackBitmap filterGenre(int code) const;
+    TrackBitmap filterGenre(const std::string& name) const;
+    TrackBitmap filterRange(Column column, float lo, float hi) const;  // lo <= value <= hi
+};
+
+} // namespace MusicAI
@@ -0,0 +1,200 @@
+#include "track_index.h"
+#include "fast_rng.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+// Points per centroid-distance GEMM; bounds the num_lists x chunk scratch
+constexpr Eigen::Index ASSIGN_CHUNK = 1024;
+
+bool fartherThan(const TrackIndex::Neighbor& a, const TrackIndex::Neighbor& b) {
+    return a.distance < b.distance;
+}
+
+} // namespace
+
+TrackIndex::TrackIndex(const Config& config) : config_(config) {
+    if (config_.num_lists <= 0 || config_.kmeans_iterations < 0) {
+        throw std::invalid_argument("Track index needs at least one list");
+    }
+}
+
+void TrackIndex::assignLists(const Eigen::Ref<const Eigen::MatrixXf>& points, std::vector<uint32_t>& lists,
+                             unsigned num_threads) const {
+    lists.resize(points.cols());
+    const size_t chunks = static_cast<size_t>((points.cols() + ASSIGN_CHUNK - 1) / ASSIGN_CHUNK);
+    parallelFor(chunks, num_threads, [&](size_t begin, size_t end) {
+        Eigen::MatrixXf scores;
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            Eigen::Index first = static_cast<Eigen::Index>(chunk) * ASSIGN_CHUNK;
+            Eigen::Index count = std::min(ASSIGN_CHUNK, points.cols() - first);
+            // ||c||^2 - 2 c.x ranks centroids like the full squared distance
+            scores.noalias() = centroids_.transpose() * points.middleCols(first, count);
+            scores = (-2.0f * scores).colwise() + centroid_norms_;
+            for (Eigen::Index j = 0; j < count; ++j) {
+                Eigen::Index best;
+                scores.col(j).minCoeff(&best);
+                lists[first + j] = static_cast<uint32_t>(best);
+            }
+        }
+    });
+}
+
+void TrackIndex::trainCentroids(const Eigen::Ref<const Eigen::MatrixXf>& embeddings) {
+    const Eigen::Index n = embeddings.cols();
+    const Eigen::Index num_lists = std::min<Eigen::Index>(config_.num_lists, n);
+    FastRng rng(config_.seed);
+    
+    // Random training sample (partial Fisher-Yates over the track order)
+    std::vector<Eigen::Index> order(n);
+    std::iota(order.begin(), order.end(), Eigen::Index(0));
+    const Eigen::Index sample_size = std::max<Eigen::Index>(
+        num_lists, std::min<Eigen::Index>(n, static_cast<Eigen::Index>(config_.training_sample)));
+    Eigen::MatrixXf sample(embeddings.rows(), sample_size);
+    for (Eigen::Index i = 0; i < sample_size; ++i) {
+        std::swap(order[i], order[i + static_cast<Eigen::Index>((rng() >> 11) % static_cast<uint64_t>(n - i))]);
+        sample.col(i) = embeddings.col(order[i]);
+    }
+    
+    centroids_ = sample.leftCols(num_lists);
+    std::vector<uint32_t> lists;
+    Eigen::MatrixXf sums(embeddings.rows(), num_lists);
+    std::vector<Eigen::Index> counts(num_lists);
+    for (int iteration = 0; iteration < config_.kmeans_iterations; ++iteration) {
+        centroid_norms_ = centroids_.colwise().squaredNorm().transpose();
+        assignLists(sample, lists, config_.num_threads);
+        
+        sums.setZero();
+        std::fill(counts.begin(), counts.end(), 0);
+        for (Eigen::Index i = 0; i < sample_size; ++i) {
+            sums.col(lists[i]) += sample.col(i);
+            ++counts[lists[i]];
+        }
+        for (Eigen::Index c = 0; c < num_lists; ++c) {
+            // Empty clusters restart from a random training point
+            centroids_.col(c) = counts[c] > 0 ? (sums.col(c) / static_cast<float>(counts[c])).eval()
+                                              : sample.col(static_cast<Eigen::Index>((rng() >> 11) % static_cast<uint64_t>(sample_size)));
+        }
+    }
+    centroid_norms_ = centroids_.colwise().squaredNorm().transpose();
+}
+
+void TrackIndex::build(const Eigen::Ref<const Eigen::MatrixXf>& embeddings, const std::vector<uint8_t>& genres) {
+    if (embeddings.cols() == 0 || static_cast<size_t>(embeddings.cols()) != genres.size()) {
+        throw std::invalid_argument("Need one genre per track embedding");
+    }
+    if (embeddings.cols() > std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Too many tracks for 32-bit track IDs");
+    }
+    for (uint8_t genre : genres) {
+        if (genre >= NUM_GENRES) {
+            throw std::invalid_argument("Track genre out of range");
+        }
+    }
+    
+    trainCentroids(embeddings);
+    std::vector<uint32_t> lists;
+    assignLists(embeddings, lists, config_.num_threads);
+    
+    // Counting sort by (list, genre)
+    const size_t runs = static_cast<size_t>(numLists()) * NUM_GENRES;
+    offsets_.assign(runs + 1, 0);
+    for (size_t i = 0; i < lists.size(); ++i) {
+        ++offsets_[lists[i] * NUM_GENRES + genres[i] + 1];
+    }
+    std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+    
+    std::vector<uint32_t> cursor(offsets_.begin(), offsets_.end() - 1);
+    ids_.resize(lists.size());
+    for (size_t i = 0; i < lists.size(); ++i) {
+        ids_[cursor[lists[i] * NUM_GENRES + genres[i]]++] = static_cast<uint32_t>(i);
+    }
+    
+    vectors_.resize(embeddings.rows(), embeddings.cols());
+    parallelFor(ids_.size(), config_.num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            vectors_.col(i) = embeddings.col(ids_[i]);
+        }
+    }, 4096);
+    vector_norms_ = vectors_.colwise().squaredNorm().transpose();
+}
+
+void TrackIndex::search(const Eigen::MatrixXf& queries, const std::vector<int>& genres, int k, int nprobe,
+                        std::vector<std::vector<Neighbor>>& results, unsigned num_threads) const {
+    if (ids_.empty()) {
+        throw std::logic_error("Track index has not been built");
+    }
+    if (queries.rows() != dim() || (!genres.empty() && genres.size() != static_cast<size_t>(queries.cols()))) {
+        throw std::invalid_argument("Query shape mismatch");
+    }
+    if (k < 1) {
+        throw std::invalid_argument("Search needs k >= 1");
+    }
+    for (int genre : genres) {
+        if (genre != ANY_GENRE && (genre < 0 || genre >= NUM_GENRES)) {
+            throw std::invalid_argument("Query genre out of range");
+        }
+    }
+    
+    const int lists_to_probe = std::max(1, std::min(nprobe, numLists()));
+    results.resize(queries.cols());
+    parallelFor(static_cast<size_t>(queries.cols()), num_threads, [&](size_t begin, size_t end) {
+        // Centroid scores for the whole range in one GEMM
+        Eigen::MatrixXf list_scores = centroids_.transpose() * queries.middleCols(begin, end - begin);
+        list_scores = (-2.0f * list_scores).colwise() + centroid_norms_;
+        std::vector<int> list_order(numLists());
+        Eigen::VectorXf dots;
+        
+        for (size_t q = begin; q < end; ++q) {
+            const int genre = genres.empty() ? ANY_GENRE : genres[q];
+            const int first_genre = genre == ANY_GENRE ? 0 : genre;
+            const int last_genre = genre == ANY_GENRE ? NUM_GENRES - 1 : genre;
+            auto runBegin = [&](int list) { return offsets_[list * NUM_GENRES + first_genre]; };
+            auto runEnd = [&](int list) { return offsets_[list * NUM_GENRES + last_genre + 1]; };
+            
+            const auto scores = list_scores.col(q - begin);
+            std::iota(list_order.begin(), list_order.end(), 0);
+            std::sort(list_order.begin(), list_order.end(),
+                      [&scores](int a, int b) { return scores(a) < scores(b); });
+            
+            const auto query = queries.col(q);
+            const float query_norm = query.squaredNorm();
+            std::vector<Neighbor>& heap = results[q];
+            heap.clear();
+            int probed = 0;
+            for (int list : list_order) {
+                if (probed == lists_to_probe) {
+                    break;
+                }
+                const uint32_t run_begin = runBegin(list);
+                const uint32_t run_end = runEnd(list);
+                if (run_begin == run_end) {
+                    continue;
+                }
+                ++probed;
+                
+                dots.noalias() = vectors_.middleCols(run_begin, run_end - run_begin).transpose() * query;
+                for (uint32_t i = run_begin; i < run_end; ++i) {
+                    float distance = vector_norms_(i) - 2.0f * dots(i - run_begin) + query_norm;
+                    if (static_cast<int>(heap.size()) < k) {
+                        heap.push_back({ids_[i], distance});
+                        std::push_heap(heap.begin(), heap.end(), fartherThan);
+                    } else if (distance < heap.front().distance) {
+                        std::pop_heap(heap.begin(), heap.end(), fartherThan);
+                        heap.back() = {ids_[i], distance};
+                        std::push_heap(heap.begin(), heap.end(), fartherThan);
+                    }
+                }
+            }
+            std::sort_heap(heap.begin(), heap.end(), fartherThan);
+        }
+    }, 16);
+}
+
+} // namespace MusicAI
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "neural_network.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <vector>
+
+namespace MusicAI {
+
+// Approximate nearest-neighbour index over track embeddings (IVF-flat): a
+// k-means coarse quantizer splits the catalog into lists, and a query scans
+// only its nprobe closest lists. Within each list tracks are grouped by
+// genre (MusicEnvironment::Action), so a query conditioned on the genre the
+// Q-network chose scans just that genre's run. Distances are squared L2 on
+// float vectors; track IDs are column indices of the embedding matrix.
+class TrackIndex {
+public:
+    static constexpr int NUM_GENRES = NeuralNetwork::OUTPUT_SIZE;
+    static constexpr int ANY_GENRE = -1;
+    
+    struct Config {
+        int num_lists = 1024;
+        int kmeans_iterations = 10;
+        size_t training_sample = 65536;  // Tracks used to fit the centroids
+        unsigned num_threads = 0;        // Build threads (0 = all cores)
+        uint64_t seed = 42;
+    };
+    
+    struct Neighbor {
+        uint32_t track;
+        float distance;
+    };
+    
+private:
+    Config config_;
+    Eigen::MatrixXf centroids_;          // dim x num_lists
+    Eigen::VectorXf centroid_norms_;     // Squared norms
+    Eigen::MatrixXf vectors_;            // dim x tracks, ordered by (list, genre)
+    Eigen::VectorXf vector_norms_;
+    std::vector<uint32_t> ids_;          // Track ID of each column of vectors_
+    std::vector<uint32_t> offsets_;      // Start of each (list, genre) run, plus the end
+    
+public:
+    TrackIndex() : TrackIndex(Config()) {}
+    explicit TrackIndex(const Config& config);
+    
+    // embeddings: dim x tracks; genres: one value in [0, NUM_GENRES) per track
+    void build(const Eigen::Ref<const Eigen::MatrixXf>& embeddings, const std::vector<uint8_t>& genres);
+    
+    // Top-k tracks for each query column, nearest first. genres holds one
+    // genre (or ANY_GENRE) per query, or is empty for no filter. Lists
+    // without tracks of the requested genre do not count toward nprobe.
+    // Throws std::invalid_argument for k < 1.
+    void search(const Eigen::MatrixXf& queries, const std::vector<int>& genres, int k, int nprobe,
+                std::vector<std::vector<Neighbor>>& results, unsigned num_threads = 0) const;
+    
+    size_t size() const { return ids_.size(); }
+    int dim() const { return static_cast<int>(centroids_.rows()); }
+    int numLists() const { return static_cast<int>(centroids_.cols()); }
+    
+private:
+    void trainCentroids(const Eigen::Ref<const Eigen::MatrixXf>& embeddings);
+    void assignLists(const Eigen::Ref<const Eigen::MatrixXf>& points, std::vector<uint32_t>& lists, unsigned num_threads) const;
+};
+
+} // namespace MusicAI
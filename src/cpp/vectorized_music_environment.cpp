@@ -0,0 +1,211 @@
+#include "vectorized_music_environment.h"
+#include "music_rl_engine.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace MusicAI {
+
+namespace {
+
+constexpr double HOUR_STEP = 4.0 / (24.0 * 60.0);  // ~4 minutes per track
+constexpr double WEATHER_CHANGE_PROB = 0.05;
+constexpr double MOOD_CHANGE_PROB = 0.3;
+
+} // namespace
+
+VectorizedMusicEnvironment::VectorizedMusicEnvironment(const Config& config)
+    : config_(config) {
+    if (config_.num_envs == 0) {
+        throw std::invalid_argument("VectorizedMusicEnvironment needs at least one environment");
+    }
+    
+    size_t n = config_.num_envs;
+    states_.resize(n);
+    next_states_.resize(n);
+    taste_.resize(n);
+    episode_step_.assign(n, 0);
+    ratings_.assign(n, 0.0);
+    rewards_.assign(n, 0.0);
+    dones_.assign(n, false);
+    
+    size_t num_shards = (n + SHARD_SIZE - 1) / SHARD_SIZE;
+    std::seed_seq seeds{config_.seed};
+    std::vector<uint32_t> shard_seeds(num_shards);
+    seeds.generate(shard_seeds.begin(), shard_seeds.end());
+    for (uint32_t seed : shard_seeds) {
+        shard_rngs_.emplace_back(seed);
+    }
+    
+    resetAll();
+}
+
+void VectorizedMusicEnvironment::resetAll() {
+    size_t n = config_.num_envs;
+    parallelFor(shard_rngs_.size(), config_.num_threads, [&](size_t shard_begin, size_t shard_end) {
+        for (size_t shard = shard_begin; shard < shard_end; ++shard) {
+            resetRange(shard_rngs_[shard], shard * SHARD_SIZE, std::min(n, (shard + 1) * SHARD_SIZE));
+        }
+    });
+}
+
+void VectorizedMusicEnvironment::resetRange(std::mt19937& rng, size_t begin, size_t end) {
+    // Same distributions as MusicEnvironment::reset, plus a fresh listener
+    std::uniform_real_distribution<double> temp_dist(-1.0, 1.0);
+    std::uniform_int_distribution<int> weather_dist(0, 4);
+    std::uniform_real_distribution<double> time_dist(0.0, 1.0);
+    std::uniform_int_distribution<int> mood_dist(0, 4);
+    std::uniform_real_distribution<double> history_dist(0.0, 1.0);
+    std::normal_distribution<double> taste_dist(0.0, 0.6);
+    
+    for (size_t i = begin; i < end; ++i) {
+        states_.temperature[i] = temp_dist(rng);
+        states_.weather_condition[i] = weather_dist(rng);
+        states_.hour_of_day[i] = time_dist(rng);
+        states_.day_of_week[i] = time_dist(rng);
+        states_.user_mood[i] = mood_dist(rng);
+        for (auto& history : states_.genre_history) {
+            history[i] = history_dist(rng);
+        }
+        for (double& affinity : taste_[i]) {
+            affinity = taste_dist(rng);
+        }
+        episode_step_[i] = 0;
+    }
+}
+
+double VectorizedMusicEnvironment::syntheticRating(std::mt19937& rng, size_t env, int action) const {
+    // Listener rating: personal taste, contextual fit (the environment's own
+    // reward shaping at a neutral rating, stored in rewards_) and mood, plus noise
+    std::normal_distribution<double> noise(0.0, config_.rating_noise);
+    double context_fit = rewards_[env];
+    bool energetic = action == 1 || action == 2 || action == 4;
+    double mood_fit = (states_.user_mood[env] / 4.0 - 0.5) * (energetic ? 1.0 : -1.0);
+    
+    double rating = 2.5 + 1.5 * taste_[env][action] + 3.0 * (context_fit - 0.35) +
+                    mood_fit + noise(rng);
+    return std::max(0.0, std::min(5.0, rating));
+}
+
+void VectorizedMusicEnvironment::step(const std::vector<int>& actions) {
+    size_t n = config_.num_envs;
+    if (actions.size() != n) {
+        throw std::invalid_argument("Action count must match number of environments");
+    }
+    for (int action : actions) {
+        if (action < 0 || action >= NUM_ACTIONS) {
+            throw std::invalid_argument("Action must be in range [0, 4]");
+        }
+    }
+    
+    // Work is split on shard boundaries: each shard owns its RNG stream and a
+    // 64-bit aligned slice of dones_, so threads never share state
+    parallelFor(shard_rngs_.size(), config_.num_threads, [&](size_t shard_begin, size_t shard_end) {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_int_distribution<int> weather_dist(0, 4);
+        std::normal_distribution<double> temp_drift(0.0, 0.02);
+        
+        for (size_t shard = shard_begin; shard < shard_end; ++shard) {
+            std::mt19937& rng = shard_rngs_[shard];
+            size_t begin = shard * SHARD_SIZE;
+            size_t end = std::min(n, begin + SHARD_SIZE);
+            
+            // Contextual fit at a neutral rating feeds the listener model
+            std::fill(ratings_.begin() + begin, ratings_.begin() + end, 2.5);
+            MusicEnvironment::calculateRewardRange(states_, actions.data(), ratings_.data(),
+                                                   rewards_.data(), begin, end);
+            for (size_t i = begin; i < end; ++i) {
+                ratings_[i] = syntheticRating(rng, i, actions[i]);
+            }
+            MusicEnvironment::calculateRewardRange(states_, actions.data(), ratings_.data(),
+                                                   rewards_.data(), begin, end);
+            
+            // Transition to the next track
+            for (size_t i = begin; i < end; ++i) {
+                double temperature = states_.temperature[i] + temp_drift(rng);
+                next_states_.temperature[i] = std::max(-1.0, std::min(1.0, temperature));
+                next_states_.weather_condition[i] = unit(rng) < WEATHER_CHANGE_PROB
+                    ? weather_dist(rng) : states_.weather_condition[i];
+                
+                double hour = states_.hour_of_day[i] + HOUR_STEP;
+                double day = states_.day_of_week[i];
+                if (hour >= 1.0) {
+                    hour -= 1.0;
+                    day = std::fmod(day + 1.0 / 7.0, 1.0);
+                }
+                next_states_.hour_of_day[i] = hour;
+                next_states_.day_of_week[i] = day;
+                
+                double mood = states_.user_mood[i];
+                if (unit(rng) < MOOD_CHANGE_PROB) {
+                    if (ratings_[i] >= 4.0) {
+                        mood = std::min(4.0, mood + 1.0);
+                    } else if (ratings_[i] <= 1.5) {
+                        mood = std::max(0.0, mood - 1.0);
+                    }
+                }
+                next_states_.user_mood[i] = mood;
+                
+                next_states_.genre_history[2][i] = states_.genre_history[1][i];
+                next_states_.genre_history[1][i] = states_.genre_history[0][i];
+                next_states_.genre_history[0][i] = actions[i] / 4.0;
+                
+                dones_[i] = ++episode_step_[i] >= config_.episode_length;
+            }
+            
+            // Continue running episodes; finished ones start a new listener
+            for (size_t i = begin; i < end; ++i) {
+                states_.set(i, next_states_.get(i));
+            }
+            for (size_t i = begin; i < end; ++i) {
+                if (dones_[i]) {
+                    resetRange(rng, i, i + 1);
+                }
+            }
+        }
+    });
+}
+
+Eigen::MatrixXd VectorizedMusicEnvironment::toObservations(const MusicEnvironment::StateBatch& states) {
+    using RowMap = Eigen::Map<const Eigen::RowVectorXd>;
+    Eigen::Index n = static_cast<Eigen::Index>(states.size());
+    
+    Eigen::MatrixXd obs(8, n);
+    obs.row(0) = RowMap(states.temperature.data(), n);
+    obs.row(1) = RowMap(states.weather_condition.data(), n) / 4.0;
+    obs.row(2) = RowMap(states.hour_of_day.data(), n);
+    obs.row(3) = RowMap(states.day_of_week.data(), n);
+    obs.row(4) = RowMap(states.user_mood.data(), n) / 4.0;
+    obs.row(5) = RowMap(states.genre_history[0].data(), n);
+    obs.row(6) = RowMap(states.genre_history[1].data(), n);
+    obs.row(7) = RowMap(states.genre_history[2].data(), n);
+    return obs;
+}
+
+VectorizedMusicEnvironment::PretrainStats
+VectorizedMusicEnvironment::pretrain(MusicRecommendationDQN& dqn, size_t transitions) {
+    PretrainStats stats;
+    double reward_sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    
+    while (stats.transitions < transitions) {
+        Eigen::MatrixXd obs = observations();
+        std::vector<int> actions = dqn.predictBatch(obs, config_.num_threads);
+        step(actions);
+        dqn.trainBatch(obs, actions, rewards_, nextObservations(), dones_);
+        
+        for (double reward : rewards_) {
+            reward_sum += reward;
+        }
+        stats.transitions += config_.num_envs;
+    }
+    
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.mean_reward = reward_sum / static_cast<double>(stats.transitions);
+    stats.transitions_per_second = stats.transitions / std::max(stats.seconds, 1e-9);
+    return stats;
+}
+
+} // namespace MusicAI
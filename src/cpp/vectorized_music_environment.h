@@ -0,0 +1,76 @@
+#pragma once
+
+#include "music_environment.h"
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <Eigen/Dense>
+
+namespace MusicAI {
+
+class MusicRecommendationDQN;
+
+// Many independent MusicEnvironment instances stepped together in SoA layout,
+// with a synthetic listener model supplying ratings. Used to pretrain
+// cold-start models by self-play before any real feedback exists.
+class VectorizedMusicEnvironment {
+public:
+    static constexpr int NUM_ACTIONS = 5;
+    static constexpr size_t SHARD_SIZE = 1024;  // Environments per RNG stream
+    
+    struct Config {
+        size_t num_envs = 4096;
+        int episode_length = 20;     // Tracks per simulated listening session
+        double rating_noise = 0.5;   // Std-dev of synthetic rating noise
+        unsigned num_threads = 0;    // 0 = all cores
+        uint32_t seed = 42;
+    };
+    
+    struct PretrainStats {
+        size_t transitions = 0;
+        double seconds = 0.0;
+        double mean_reward = 0.0;
+        double transitions_per_second = 0.0;
+    };
+    
+private:
+    Config config_;
+    MusicEnvironment::StateBatch states_;
+    MusicEnvironment::StateBatch next_states_;
+    std::vector<std::array<double, NUM_ACTIONS>> taste_;  // Latent per-listener genre affinity
+    std::vector<int> episode_step_;
+    std::vector<double> ratings_;
+    std::vector<double> rewards_;
+    std::vector<bool> dones_;
+    std::vector<std::mt19937> shard_rngs_;  // One stream per shard: deterministic for any thread count
+    
+public:
+    VectorizedMusicEnvironment() : VectorizedMusicEnvironment(Config()) {}
+    explicit VectorizedMusicEnvironment(const Config& config);
+    
+    // Environment interface
+    void resetAll();
+    void step(const std::vector<int>& actions);
+    
+    size_t size() const { return config_.num_envs; }
+    const MusicEnvironment::StateBatch& states() const { return states_; }
+    const MusicEnvironment::StateBatch& nextStates() const { return next_states_; }
+    const std::vector<double>& ratings() const { return ratings_; }
+    const std::vector<double>& rewards() const { return rewards_; }
+    const std::vector<bool>& dones() const { return dones_; }
+    
+    // Network inputs (8 x num_envs), matching MusicEnvironment::stateToVector
+    Eigen::MatrixXd observations() const { return toObservations(states_); }
+    Eigen::MatrixXd nextObservations() const { return toObservations(next_states_); }
+    
+    // Self-play loop: predictBatch -> step -> trainBatch until at least
+    // `transitions` transitions have been fed to the model
+    PretrainStats pretrain(MusicRecommendationDQN& dqn, size_t transitions);
+    
+private:
+    static Eigen::MatrixXd toObservations(const MusicEnvironment::StateBatch& states);
+    void resetRange(std::mt19937& rng, size_t begin, size_t end);
+    double syntheticRating(std::mt19937& rng, size_t env, int action) const;
+};
+
+} // namespace MusicAI
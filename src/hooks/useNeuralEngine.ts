@@ -20,6 +20,17 @@ interface LayerInfo {
   color: string;
 }
 
+interface LayerSummary {
+  layer: number;
+  neuronCount: number;
+  activeCount: number;
+  lowCount: number;
+  mediumCount: number;
+  highCount: number;
+  maxActivation: number;
+  meanActivation: number;
+}
+
 export const useNeuralEngine = () => {
   const [engineState, setEngineState] = useState<EngineState>({
     isReady: false,
@@ -49,6 +60,8 @@ export const useNeuralEngine = () => {
         script.onload = async () => {
           if (window.MusicEngine) {
             await window.MusicEngine.initialize();
+            // The visualizer shows every prediction, so capture all of them
+            window.MusicEngine.setActivationSampling(1);
             const info = window.MusicEngine.getLayerInfo();
             setLayerInfo(info);
             setEngineState({
@@ -125,21 +138,22 @@ export const useNeuralEngine = () => {
     }> = [];
     
     for (let i = 0; i < layerInfo.length; i++) {
-      const layerActivations = window.MusicEngine.getActivations(i);
-      newActivations.push(layerActivations);
-      
-      // Detailed layer analysis for educational transparency
+      newActivations.push(window.MusicEngine.getActivations(i));
+    }
+
+    // Per-layer statistics are computed by the engine in one pass
+    for (const summary of window.MusicEngine.getLayerSummaries()) {
       layerActivationDetails.push({
-        layerIndex: i,
-        layerName: layerInfo[i]?.name || `Layer ${i}`,
-        neuronCount: layerActivations.length,
-        activeNeurons: layerActivations.filter(a => a > 0.1).length,
-        maxActivation: Math.max(...layerActivations),
-        avgActivation: layerActivations.reduce((a, b) => a + b, 0) / layerActivations.length,
+        layerIndex: summary.layer,
+        layerName: layerInfo[summary.layer]?.name || `Layer ${summary.layer}`,
+        neuronCount: summary.neuronCount,
+        activeNeurons: summary.activeCount,
+        maxActivation: summary.maxActivation,
+        avgActivation: summary.meanActivation,
         activationDistribution: {
-          low: layerActivations.filter(a => a < 0.3).length,
-          medium: layerActivations.filter(a => a >= 0.3 && a < 0.7).length,
-          high: layerActivations.filter(a => a >= 0.7).length
+          low: summary.lowCount,
+          medium: summary.mediumCount,
+          high: summary.highCount
         }
       });
     }
@@ -164,7 +178,7 @@ export const useNeuralEngine = () => {
         dominant_input: context.temperature > 0.5 ? 'temperature' : 
                        context.weather_condition > 2 ? 'weather' : 
                        context.user_mood > 2 ? 'mood' : 'time',
-        prediction_confidence: Math.max(...newActivations[newActivations.length - 1] || [0]),
+        prediction_confidence: layerActivationDetails[layerActivationDetails.length - 1]?.maxActivation ?? 0,
         decision_factors: {
           weather_influence: Math.abs(context.weather_condition - 2) * 0.25,
           time_influence: Math.abs(context.hour - 0.5) * 0.3,
@@ -286,7 +300,9 @@ declare global {
       initialize: () => Promise<void>;
       predict: (...args: number[]) => number;
       train: (...args: number[]) => void;
+      setActivationSampling: (everyN: number) => void;
       getActivations: (layer: number) => number[];
+      getLayerSummaries: () => LayerSummary[];
       getLayerInfo: () => LayerInfo[];
       getQValues: (...args: number[]) => number[];
       getTrainingMetrics: () => NeuralMetrics;